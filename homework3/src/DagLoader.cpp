@@ -0,0 +1,220 @@
+#include "DagLoader.h"
+
+#include <charconv>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "NetlistLexer.h"
+#include "hls_error.h"
+#include "trace.h"
+#include "resources.h"
+#include "resource_library.h"
+
+namespace {
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Whitespace separated fields of one line, as views into the mapped file
+void splitFields(std::string_view line, std::vector<std::string_view>& fields) {
+    fields.clear();
+    size_t iter = 0;
+    while (iter < line.size()) {
+        while (iter < line.size() && isBlank(line[iter])) {
+            iter++;
+        }
+        size_t start = iter;
+        while (iter < line.size() && !isBlank(line[iter])) {
+            iter++;
+        }
+        if (iter > start) {
+            fields.push_back(line.substr(start, iter - start));
+        }
+    }
+}
+
+[[noreturn]] void dagError(const std::string& filePath, int lineNumber, const std::string& message, HlsErrorKind kind = HlsErrorKind::failure) {
+    throw HlsError("Error: " + message + " at line " + std::to_string(lineNumber) + " of DAG file '" + filePath + "'", kind);
+}
+
+uint64_t edgeKey(int from, int to) {
+    return (static_cast<uint64_t>(from) << 32) | static_cast<uint32_t>(to);
+}
+
+}
+
+OperationGraph loadDag(const std::string& filePath) {
+    TraceSpan span("frontend", "load DAG");
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        throw HlsError("Error: Unable to read DAG file '" + filePath + "'");
+    }
+    std::string_view source = file.contents();
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+
+    OperationGraph opGraph;
+    Operation sourceOp;
+    sourceOp.name = "source";
+    sourceOp.opType = "Source";
+    sourceOp.resource = "None";
+    opGraph.addNode(sourceOp);
+
+    enum class Section { None, Nodes, Dependencies };
+    Section section = Section::None;
+    std::unordered_map<std::string_view, int> ids;
+    // First line of every dependency, for the cycle message
+    std::unordered_map<uint64_t, int> edgeLines;
+    std::vector<std::string_view> fields;
+    size_t position = 0;
+    int lineNumber = 0;
+    while (position < source.size()) {
+        size_t lineEnd = source.find('\n', position);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = source.size();
+        }
+        std::string_view line = source.substr(position, lineEnd - position);
+        position = lineEnd + 1;
+        lineNumber++;
+
+        splitFields(line, fields);
+        if (fields.empty() || fields[0][0] == '#') {
+            continue;
+        }
+        if (fields.size() == 1 && fields[0] == "/") {
+            section = Section::Nodes;
+            continue;
+        }
+        if (fields.size() == 1 && fields[0] == "-") {
+            section = Section::Dependencies;
+            continue;
+        }
+
+        if (section == Section::Nodes) {
+            if (fields.size() < 4) {
+                dagError(filePath, lineNumber, "Expected 'name type inputs... output datawidth'");
+            }
+            std::string type(fields[1]);
+            int resource_id = registry.id_of_name(type);
+            if (resource_id < 0) {
+                resource_id = registry.id_of_op_type(type);
+            }
+            if (resource_id < 0) {
+                dagError(filePath, lineNumber, "Unknown operation type '" + type + "'");
+            }
+            std::string_view widthField = fields.back();
+            int width = 0;
+            auto parsed = std::from_chars(widthField.data(), widthField.data() + widthField.size(), width);
+            if (parsed.ec != std::errc() || parsed.ptr != widthField.data() + widthField.size() || width < 1) {
+                dagError(filePath, lineNumber, "Invalid datawidth '" + std::string(widthField) + "'");
+            }
+
+            Operation op;
+            op.name = std::string(fields[0]);
+            op.opType = type;
+            op.fds_type = registry.at(resource_id).name;
+            op.resource = registry.at(resource_id).resource;
+            op.width = width;
+            // Resource class names have no library entry of their own
+            const OperationTiming* timing = ResourceLibrary::instance().find(type, width);
+            op.cycles = timing != nullptr ? timing->cycles : registry.at(resource_id).cycles;
+            op.line = std::string(line);
+            op.result = std::string(fields[fields.size() - 2]);
+            op.isSigned = false;
+            for (size_t field = 2; field + 2 < fields.size(); field++) {
+                op.operands.push_back(std::string(fields[field]));
+                op.operandIds.push_back(SymbolTable::npos);
+            }
+            if (!ids.emplace(fields[0], opGraph.operations.size()).second) {
+                dagError(filePath, lineNumber, "Duplicate node '" + op.name + "'");
+            }
+            opGraph.addNode(op);
+        } else if (section == Section::Dependencies) {
+            if (fields.size() != 2) {
+                dagError(filePath, lineNumber, "Expected 'predecessor successor'");
+            }
+            auto from = ids.find(fields[0]);
+            auto to = ids.find(fields[1]);
+            if (from == ids.end() || to == ids.end()) {
+                std::string_view missing = from == ids.end() ? fields[0] : fields[1];
+                dagError(filePath, lineNumber, "Unknown node '" + std::string(missing) + "'");
+            }
+            if (from->second == to->second) {
+                dagError(filePath, lineNumber, "Dependency cycle '" + std::string(fields[0]) + "' -> '" + std::string(fields[0]) + "'", HlsErrorKind::invalid_design);
+            }
+            opGraph.addEdge(from->second, to->second, opGraph.operations[from->second].result);
+            edgeLines.emplace(edgeKey(from->second, to->second), lineNumber);
+        } else {
+            dagError(filePath, lineNumber, "Expected '/' before the node list");
+        }
+    }
+
+    Operation sinkOp;
+    sinkOp.name = "sink";
+    sinkOp.opType = "Sink";
+    sinkOp.resource = "None";
+    opGraph.addNode(sinkOp);
+    opGraph.finalize();
+
+    // Kahn's algorithm over the linked graph; operations left over sit on a cycle
+    std::vector<int> pending(opGraph.operations.size());
+    std::vector<int> ready;
+    for (size_t id = 0; id < opGraph.operations.size(); id++) {
+        pending[id] = opGraph.dependencies.predecessors(id).size();
+        if (pending[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        int id = ready.back();
+        ready.pop_back();
+        visited++;
+        for (int successor : opGraph.dependencies.successors(id)) {
+            if (--pending[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    }
+    if (visited != opGraph.operations.size()) {
+        // Every operation left over has a predecessor left over; walking back along them
+        // from any of them ends up going round the cycle
+        auto leftoverPredecessor = [&opGraph, &pending](int id) {
+            for (int predecessor : opGraph.dependencies.predecessors(id)) {
+                if (pending[predecessor] > 0) {
+                    return predecessor;
+                }
+            }
+            return -1;
+        };
+        int id = 0;
+        while (pending[id] == 0) {
+            id++;
+        }
+        std::vector<bool> seen(opGraph.operations.size(), false);
+        while (!seen[id]) {
+            seen[id] = true;
+            id = leftoverPredecessor(id);
+        }
+        // id is on the cycle; list it in dependency order, closing with the edge into id
+        std::vector<int> cycle = {id};
+        for (int predecessor = leftoverPredecessor(id); predecessor != id; predecessor = leftoverPredecessor(predecessor)) {
+            cycle.push_back(predecessor);
+        }
+        std::string path = "'" + opGraph.operations[id].name + "'";
+        for (auto iter = cycle.rbegin(); iter != cycle.rend(); ++iter) {
+            path += " -> '" + opGraph.operations[*iter].name + "'";
+        }
+        auto line = edgeLines.find(edgeKey(cycle[1 % cycle.size()], id));
+        dagError(filePath, line != edgeLines.end() ? line->second : lineNumber, "Dependency cycle " + path, HlsErrorKind::invalid_design);
+    }
+    return opGraph;
+}
+
+void printSchedule(const Graph& graph, std::ostream& out) {
+    out << "# Name, type, state" << std::endl;
+    for (const auto& vertex : graph.vertices) {
+        out << vertex->name << " " << vertex->type << " " << vertex->fds_time + 1 << std::endl;
+    }
+}
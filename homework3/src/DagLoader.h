@@ -0,0 +1,25 @@
+#ifndef DAGLOADER_H
+#define DAGLOADER_H
+
+#include <iostream>
+#include <string>
+
+#include "OpPostProcess.h"
+#include "graph.h"
+
+// Reads a DAG in the intermediate text format (see intermediate_test_files):
+//
+//   /                                 start of the node list
+//   MUL1 MUL a b k 8                  name, type, inputs..., output, datawidth
+//   -                                 start of the dependency list
+//   MUL1 MUL5                         MUL5 depends on MUL1
+//
+// Lines starting with '#' are comments. The type is a resource class name (ADD_SUB, MUL,
+// LOG, DIV_MOD) or an operation type (ADD, COMP, ...). The nodes become the operations of
+// the graph, between a source and a sink, without going through the netlist front end.
+OperationGraph loadDag(const std::string& filePath);
+
+// One line per scheduled operation in DAG order: name, resource class and 1-based state
+void printSchedule(const Graph& graph, std::ostream& out);
+
+#endif // DAGLOADER_H
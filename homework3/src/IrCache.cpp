@@ -0,0 +1,525 @@
+#include "IrCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <unistd.h>
+
+#include "NetlistLexer.h"
+#include "resources.h"
+#include "resource_library.h"
+#include "trace.h"
+
+// Layout of a .hlsir file: a fixed header followed by 8-byte aligned arrays of POD records
+// (components, operations, operands, edges, warnings) and a string pool. Records refer to strings by
+// offset into the pool and to each other by index, so the mapped file is read in place.
+namespace {
+
+const char irMagic[8] = {'H', 'L', 'S', 'I', 'R', 0, 0, 0};
+const uint32_t irVersion = 4;
+
+struct IrString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct IrComponent {
+    IrString type;
+    IrString name;
+    int32_t width;
+    uint8_t isSigned;
+    uint8_t declaredSigned;
+    uint8_t isReg;
+    uint8_t isNew;
+};
+
+struct IrOperation {
+    IrString opType;
+    IrString symbol;
+    IrString line;
+    IrString result;
+    IrString condition;
+    IrString name;
+    IrString fds_type;
+    IrString resource;
+    int32_t width;
+    int32_t order;
+    int32_t prev_order;
+    int32_t cycles;
+    int32_t resultId;
+    int32_t conditionId;
+    uint32_t firstOperand;
+    uint32_t operandCount;
+    uint8_t isSigned;
+    uint8_t isBranch;
+    uint8_t enter_branch;
+    uint8_t padding[5];
+};
+
+struct IrOperand {
+    IrString name;
+    int32_t id;
+};
+
+struct IrEdge {
+    int32_t from;
+    int32_t to;
+    IrString condition;
+};
+
+struct IrSection {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct IrHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t sourceHash;
+    uint64_t configHash;
+    int64_t optimized[4];  // OptimizationReport: operations, folded, common, dead
+    IrSection components;
+    IrSection operations;
+    IrSection operands;
+    IrSection edges;
+    IrSection warnings;
+    IrSection strings;
+};
+
+uint64_t fnv1a(std::string_view data, uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Resource classes and the resource library decide the resource and cycles stored on every operation
+uint64_t hashConfiguration() {
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+    uint64_t hash = fnv1a(std::string_view(reinterpret_cast<const char*>(&irVersion), sizeof(irVersion)));
+    for (size_t id = 0; id < registry.size(); id++) {
+        const ResourceClass& resourceClass = registry.at(id);
+        hash = fnv1a(resourceClass.name, hash);
+        hash = fnv1a(resourceClass.resource, fnv1a("|", hash));
+        hash = fnv1a(std::to_string(resourceClass.cycles), fnv1a("|", hash));
+        for (const auto& opType : resourceClass.op_types) {
+            hash = fnv1a(opType, fnv1a("|", hash));
+        }
+        hash = fnv1a(";", hash);
+    }
+    for (const auto& entry : ResourceLibrary::instance().entries()) {
+        hash = fnv1a(entry.first, fnv1a("|", hash));
+        for (const auto& timing : entry.second) {
+            hash = fnv1a(std::to_string(timing.width) + ":" + std::to_string(timing.cycles), fnv1a("|", hash));
+        }
+    }
+    return hash;
+}
+
+// Interns strings into the pool while the records are written
+class StringPool {
+public:
+    IrString add(const std::string& text) {
+        auto found = offsets.find(text);
+        if (found != offsets.end()) {
+            return {found->second, static_cast<uint32_t>(text.size())};
+        }
+        uint32_t offset = bytes.size();
+        bytes.insert(bytes.end(), text.begin(), text.end());
+        offsets.emplace(text, offset);
+        return {offset, static_cast<uint32_t>(text.size())};
+    }
+
+    const std::vector<char>& data() const { return bytes; }
+
+private:
+    std::vector<char> bytes;
+    std::unordered_map<std::string, uint32_t> offsets;
+};
+
+size_t alignUp(size_t offset) {
+    return (offset + 7) & ~size_t(7);
+}
+
+// Bounds-checked view of the mapped file
+class IrReader {
+public:
+    explicit IrReader(std::string_view file) : file(file) {}
+
+    template <typename T>
+    const T* section(const IrSection& section) const {
+        if (section.offset % alignof(T) != 0 || section.offset > file.size() ||
+            section.count > (file.size() - section.offset) / sizeof(T)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(file.data() + section.offset);
+    }
+
+    void setStrings(std::string_view pool) { strings = pool; }
+
+    bool valid(const IrString& text) const {
+        return text.offset <= strings.size() && text.length <= strings.size() - text.offset;
+    }
+
+    std::string text(const IrString& text) const {
+        return std::string(strings.substr(text.offset, text.length));
+    }
+
+private:
+    std::string_view file;
+    std::string_view strings;
+};
+
+}
+
+uint64_t hashSource(std::string_view source) {
+    return fnv1a(source);
+}
+
+std::string defaultCacheDirectory() {
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome != nullptr && cacheHome[0] == '/') {
+        return std::string(cacheHome) + "/hlsyn";
+    }
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && home[0] == '/') {
+        return std::string(home) + "/.cache/hlsyn";
+    }
+    return "";
+}
+
+std::string irCachePath(const std::string& sourcePath, const std::string& cacheDirectory) {
+    // Netlists of the same name in different directories get different entries
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(sourcePath, error);
+    char suffix[17];
+    std::snprintf(suffix, sizeof(suffix), "%016llx", static_cast<unsigned long long>(fnv1a(error ? sourcePath : absolute.string())));
+    std::string stem = std::filesystem::path(sourcePath).stem().string();
+    return (std::filesystem::path(cacheDirectory) / (stem + "-" + suffix + ".hlsir")).string();
+}
+
+bool loadCachedDesign(const std::string& cachePath, uint64_t sourceHash, CompiledDesign& design) {
+    MappedFile mapped(cachePath);
+    if (!mapped.isOpen()) {
+        return false;
+    }
+    std::string_view file = mapped.contents();
+    if (file.size() < sizeof(IrHeader)) {
+        return false;
+    }
+    IrHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, irMagic, sizeof(irMagic)) != 0 || header.version != irVersion ||
+        header.headerSize != sizeof(IrHeader) || header.sourceHash != sourceHash ||
+        header.configHash != hashConfiguration()) {
+        return false;
+    }
+
+    IrReader reader(file);
+    const IrComponent* components = reader.section<IrComponent>(header.components);
+    const IrOperation* operations = reader.section<IrOperation>(header.operations);
+    const IrOperand* operands = reader.section<IrOperand>(header.operands);
+    const IrEdge* edges = reader.section<IrEdge>(header.edges);
+    const IrString* warnings = reader.section<IrString>(header.warnings);
+    const char* strings = reader.section<char>(header.strings);
+    if (components == nullptr || operations == nullptr || operands == nullptr || edges == nullptr ||
+        warnings == nullptr || strings == nullptr || header.operations.count < 2) {
+        return false;
+    }
+    reader.setStrings(std::string_view(strings, header.strings.count));
+
+    int64_t numComponents = header.components.count;
+    int64_t numOperations = header.operations.count;
+    auto validSymbol = [numComponents](int32_t id) {
+        return id == SymbolTable::npos || (id >= 0 && id < numComponents);
+    };
+
+    // Validate every record before building anything, so a corrupt file leaves design untouched
+    for (uint64_t index = 0; index < header.components.count; index++) {
+        const IrComponent& component = components[index];
+        if (!reader.valid(component.type) || !reader.valid(component.name)) {
+            return false;
+        }
+    }
+    for (uint64_t index = 0; index < header.operations.count; index++) {
+        const IrOperation& op = operations[index];
+        if (!reader.valid(op.opType) || !reader.valid(op.symbol) || !reader.valid(op.line) ||
+            !reader.valid(op.result) || !reader.valid(op.condition) || !reader.valid(op.name) ||
+            !reader.valid(op.fds_type) || !reader.valid(op.resource) ||
+            !validSymbol(op.resultId) || !validSymbol(op.conditionId) ||
+            op.firstOperand > header.operands.count || op.operandCount > header.operands.count - op.firstOperand) {
+            return false;
+        }
+    }
+    for (uint64_t index = 0; index < header.operands.count; index++) {
+        if (!reader.valid(operands[index].name) || !validSymbol(operands[index].id)) {
+            return false;
+        }
+    }
+    for (uint64_t index = 0; index < header.edges.count; index++) {
+        const IrEdge& edge = edges[index];
+        if (edge.from < 0 || edge.from >= numOperations || edge.to < 0 || edge.to >= numOperations ||
+            !reader.valid(edge.condition)) {
+            return false;
+        }
+    }
+    for (uint64_t index = 0; index < header.warnings.count; index++) {
+        if (!reader.valid(warnings[index])) {
+            return false;
+        }
+    }
+
+    CompiledDesign loaded;
+    loaded.components.reserve(header.components.count);
+    for (uint64_t index = 0; index < header.components.count; index++) {
+        const IrComponent& record = components[index];
+        Component component;
+        component.type = reader.text(record.type);
+        component.name = reader.text(record.name);
+        component.width = record.width;
+        component.isSigned = record.isSigned;
+        component.declaredSigned = record.declaredSigned;
+        component.isReg = record.isReg;
+        component.isNew = record.isNew;
+        loaded.components.push_back(std::move(component));
+    }
+
+    OperationGraph& graph = loaded.graph;
+    graph.operations.reserve(header.operations.count);
+    for (uint64_t index = 0; index < header.operations.count; index++) {
+        const IrOperation& record = operations[index];
+        Operation op;
+        op.opType = reader.text(record.opType);
+        op.symbol = reader.text(record.symbol);
+        op.line = reader.text(record.line);
+        op.result = reader.text(record.result);
+        op.condition = reader.text(record.condition);
+        op.name = reader.text(record.name);
+        op.fds_type = reader.text(record.fds_type);
+        op.resource = reader.text(record.resource);
+        op.width = record.width;
+        op.isSigned = record.isSigned;
+        op.isBranch = record.isBranch;
+        op.enter_branch = record.enter_branch;
+        op.order = record.order;
+        op.prev_order = record.prev_order;
+        op.cycles = record.cycles;
+        op.resultId = record.resultId;
+        op.conditionId = record.conditionId;
+        op.operands.reserve(record.operandCount);
+        op.operandIds.reserve(record.operandCount);
+        for (uint32_t operand = 0; operand < record.operandCount; operand++) {
+            op.operands.push_back(reader.text(operands[record.firstOperand + operand].name));
+            op.operandIds.push_back(operands[record.firstOperand + operand].id);
+        }
+        graph.addNode(op);
+    }
+
+    // The edges were reduced before they were written, only the source/sink links are rebuilt
+    graph.edges.reserve(header.edges.count);
+    for (uint64_t index = 0; index < header.edges.count; index++) {
+        graph.edges.push_back({edges[index].from, edges[index].to, reader.text(edges[index].condition)});
+    }
+    graph.link();
+
+    loaded.optimization.operations = header.optimized[0];
+    loaded.optimization.folded = header.optimized[1];
+    loaded.optimization.common = header.optimized[2];
+    loaded.optimization.dead = header.optimized[3];
+    for (uint64_t index = 0; index < header.warnings.count; index++) {
+        loaded.warnings.push_back(reader.text(warnings[index]));
+    }
+    design = std::move(loaded);
+    return true;
+}
+
+bool saveCachedDesign(const std::string& cachePath, uint64_t sourceHash, const CompiledDesign& design) {
+    StringPool pool;
+    std::vector<IrComponent> components;
+    components.reserve(design.components.size());
+    for (const auto& component : design.components) {
+        IrComponent record = {};
+        record.type = pool.add(component.type);
+        record.name = pool.add(component.name);
+        record.width = component.width;
+        record.isSigned = component.isSigned;
+        record.declaredSigned = component.declaredSigned;
+        record.isReg = component.isReg;
+        record.isNew = component.isNew;
+        components.push_back(record);
+    }
+
+    std::vector<IrOperation> operations;
+    std::vector<IrOperand> operands;
+    operations.reserve(design.graph.operations.size());
+    for (const auto& op : design.graph.operations) {
+        if (op.operands.size() != op.operandIds.size()) {
+            return false;
+        }
+        IrOperation record = {};
+        record.opType = pool.add(op.opType);
+        record.symbol = pool.add(op.symbol);
+        record.line = pool.add(op.line);
+        record.result = pool.add(op.result);
+        record.condition = pool.add(op.condition);
+        record.name = pool.add(op.name);
+        record.fds_type = pool.add(op.fds_type);
+        record.resource = pool.add(op.resource);
+        record.width = op.width;
+        record.order = op.order;
+        record.prev_order = op.prev_order;
+        record.cycles = op.cycles;
+        record.resultId = op.resultId;
+        record.conditionId = op.conditionId;
+        record.firstOperand = operands.size();
+        record.operandCount = op.operands.size();
+        record.isSigned = op.isSigned;
+        record.isBranch = op.isBranch;
+        record.enter_branch = op.enter_branch;
+        for (size_t operand = 0; operand < op.operands.size(); operand++) {
+            operands.push_back({pool.add(op.operands[operand]), op.operandIds[operand]});
+        }
+        operations.push_back(record);
+    }
+
+    std::vector<IrEdge> edges;
+    edges.reserve(design.graph.edges.size());
+    for (const auto& edge : design.graph.edges) {
+        edges.push_back({edge.from, edge.to, pool.add(edge.condition)});
+    }
+
+    std::vector<IrString> warnings;
+    for (const auto& warning : design.warnings) {
+        warnings.push_back(pool.add(warning));
+    }
+
+    IrHeader header = {};
+    std::memcpy(header.magic, irMagic, sizeof(irMagic));
+    header.version = irVersion;
+    header.headerSize = sizeof(IrHeader);
+    header.sourceHash = sourceHash;
+    header.configHash = hashConfiguration();
+    header.optimized[0] = design.optimization.operations;
+    header.optimized[1] = design.optimization.folded;
+    header.optimized[2] = design.optimization.common;
+    header.optimized[3] = design.optimization.dead;
+    size_t offset = sizeof(IrHeader);
+    auto place = [&offset](IrSection& section, size_t count, size_t recordSize) {
+        offset = alignUp(offset);
+        section = {offset, count};
+        offset += count * recordSize;
+    };
+    place(header.components, components.size(), sizeof(IrComponent));
+    place(header.operations, operations.size(), sizeof(IrOperation));
+    place(header.operands, operands.size(), sizeof(IrOperand));
+    place(header.edges, edges.size(), sizeof(IrEdge));
+    place(header.warnings, warnings.size(), sizeof(IrString));
+    place(header.strings, pool.data().size(), 1);
+
+    std::vector<char> image(offset, 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    auto copy = [&image](const IrSection& section, const void* data, size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(image.data() + section.offset, data, bytes);
+        }
+    };
+    copy(header.components, components.data(), components.size() * sizeof(IrComponent));
+    copy(header.operations, operations.data(), operations.size() * sizeof(IrOperation));
+    copy(header.operands, operands.data(), operands.size() * sizeof(IrOperand));
+    copy(header.edges, edges.data(), edges.size() * sizeof(IrEdge));
+    copy(header.warnings, warnings.data(), warnings.size() * sizeof(IrString));
+    copy(header.strings, pool.data().data(), pool.data().size());
+
+    // Write beside the target and rename, so a concurrent reader never maps a partial file
+    std::string tempPath = cachePath + "." + std::to_string(getpid()) + "." +
+                           std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(image.data(), image.size());
+    out.close();
+    if (!out || std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+CompiledDesign compileDesign(const std::string& cFilePath, const std::string& cacheDirectory) {
+    CompiledDesign design;
+    bool useCache = !cacheDirectory.empty();
+    std::string cachePath = useCache ? irCachePath(cFilePath, cacheDirectory) : "";
+    uint64_t sourceHash = 0;
+    {
+        MappedFile source(cFilePath);
+        sourceHash = hashSource(source.contents());
+    }
+    if (useCache) {
+        TraceSpan span("frontend", "load IR cache");
+        if (loadCachedDesign(cachePath, sourceHash, design)) {
+            span.arg("hit", 1);
+            return design;
+        }
+        span.arg("hit", 0);
+    }
+
+    NetlistParser parser(cFilePath);
+    //parser.modifyModuleName(moduleName);
+    {
+        TraceSpan span("frontend", "parse");
+        span.arg("file", cFilePath);
+        parser.parse();
+    }
+
+    // Now, generate the Graphviz file to visualize the operation graph
+    // Construct the .dot file name based on moduleName
+
+    // Execute the command using std::system
+#if defined(ENABLE_LOGGING)  
+    std::cout << "GetComponents" << std::endl;
+    for (int i = 0; i < parser.getComponents().size(); ++i) {
+        std::cout << parser.getComponents()[i].name << ":" << parser.getComponents()[i].type << std::endl;
+    }
+    std::cout << std::endl;
+    
+    std::cout << "GetOperations" << std::endl;
+    for (int i = 0; i < parser.getOperations().size(); ++i) {
+        std::cout << parser.getOperations()[i].symbol << ":" << parser.getOperations()[i].opType << std::endl;
+    }
+    std::cout << std::endl;
+    // Now, call the OpPostProcess function passing the module name
+#endif
+
+    {
+        TraceSpan span("frontend", "optimize");
+        design.optimization = optimizeOperations(parser);
+        span.arg("folded", design.optimization.folded);
+        span.arg("common", design.optimization.common);
+        span.arg("dead", design.optimization.dead);
+    }
+
+    std::string moduleName = std::filesystem::path(cFilePath).stem().string();
+    {
+        TraceSpan span("frontend", "OpPostProcess");
+        design.graph = OpPostProcess(moduleName, parser);
+        design.components = parser.getComponents();
+        design.warnings = parser.getWarnings();
+        span.arg("operations", design.graph.operations.size());
+        span.arg("edges", design.graph.edges.size());
+    }
+    if (useCache) {
+        TraceSpan span("frontend", "save IR cache");
+        std::error_code error;
+        std::filesystem::create_directories(cacheDirectory, error);
+        saveCachedDesign(cachePath, sourceHash, design);
+    }
+    return design;
+}
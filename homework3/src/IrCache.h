@@ -0,0 +1,46 @@
+#ifndef IRCACHE_H
+#define IRCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "OpPostProcess.h"
+#include "IrOptimizer.h"
+
+// Everything the scheduler and Verilog generator need from the front end
+struct CompiledDesign {
+    std::vector<Component> components;
+    OperationGraph graph;
+    // What optimizeOperations removed before the graph was built
+    OptimizationReport optimization;
+    // Parser warnings, kept with the cached IR so a cache hit reports them as well
+    std::vector<std::string> warnings;
+};
+
+// FNV-1a hash of the netlist source, the key a cached IR is checked against
+uint64_t hashSource(std::string_view source);
+
+// $XDG_CACHE_HOME/hlsyn, else ~/.cache/hlsyn; empty when neither variable is set
+std::string defaultCacheDirectory();
+
+// The cached IR of dir/foo.c is <cacheDirectory>/foo-<hash of the absolute path>.hlsir
+std::string irCachePath(const std::string& sourcePath, const std::string& cacheDirectory);
+
+// Fills design from the cache file when it was written for this source and the current
+// resource classes; returns false (leaving design untouched) for a missing, stale or corrupt file.
+// The records are validated in the mapping but still copied into Operation and Component
+// objects, which the scheduler and Verilog generator consume, so strings beyond the small
+// string buffer (e.g. Operation::line) are allocated per node: a hit skips the front end,
+// not the allocations.
+bool loadCachedDesign(const std::string& cachePath, uint64_t sourceHash, CompiledDesign& design);
+
+// Writes the post-processed design; returns false when the file cannot be written
+bool saveCachedDesign(const std::string& cachePath, uint64_t sourceHash, const CompiledDesign& design);
+
+// Runs the front end (NetlistParser, optimizeOperations and OpPostProcess) on the netlist, or loads its cached
+// result from cacheDirectory when it is fresh; a parse refreshes the cache. An empty cacheDirectory disables it.
+CompiledDesign compileDesign(const std::string& cFilePath, const std::string& cacheDirectory);
+
+#endif // IRCACHE_H
@@ -0,0 +1,541 @@
+#include "IrOptimizer.h"
+
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// A value known at compile time: its low width bits and how Verilog extends it
+struct Constant {
+    uint64_t bits = 0;
+    int width = 0;
+    bool isSigned = false;
+};
+
+uint64_t mask(int width) {
+    return width >= 64 ? ~0ull : (1ull << width) - 1;
+}
+
+// The constant widened to 64 bits in an expression of the given signedness
+uint64_t extend(const Constant& value, bool isSigned) {
+    uint64_t bits = value.bits & mask(value.width);
+    if (isSigned && value.width < 64 && ((bits >> (value.width - 1)) & 1)) {
+        bits |= ~mask(value.width);
+    }
+    return bits;
+}
+
+// A sized literal reads exactly like a register of that width and signedness
+std::string formatLiteral(const Constant& value) {
+    return std::to_string(value.width) + (value.isSigned ? "'sd" : "'d") + std::to_string(value.bits & mask(value.width));
+}
+
+// Decimal literal of the netlist (an unsized literal, a signed 32-bit integer) or one of formatLiteral
+bool parseLiteral(const std::string& text, Constant& value) {
+    size_t quote = text.find('\'');
+    if (quote == std::string::npos) {
+        if (!isNumeric(text) || text.size() > 10 || std::stoull(text) > INT32_MAX) {
+            return false;
+        }
+        value = {std::stoull(text), 32, true};
+        return true;
+    }
+    value.isSigned = quote + 1 < text.size() && text[quote + 1] == 's';
+    size_t digits = quote + (value.isSigned ? 3 : 2);
+    if (!isNumeric(text.substr(0, quote)) || digits > text.size() || text[digits - 1] != 'd' ||
+        !isNumeric(text.substr(digits)) || text.size() - digits > 20 || quote > 2) {
+        return false;
+    }
+    value.width = std::stoi(text.substr(0, quote));
+    value.bits = std::stoull(text.substr(digits));
+    return value.width >= 1 && value.width <= 64;
+}
+
+// Evaluates the operation with Verilog's sizing rules: the operands of arithmetic take the width
+// of the widest of them and the result, and are signed only when all of them are
+bool foldOperation(const std::string& symbol, const std::vector<Constant>& operands, const Component& result, Constant& value) {
+    if (result.width < 1 || result.width > 64) {
+        return false;
+    }
+    value.width = result.width;
+    value.isSigned = result.isSigned;
+    const Constant& left = operands[0];
+    const Constant& right = operands[1];
+    if (symbol == "?") {
+        bool isSigned = operands[1].isSigned && operands[2].isSigned;
+        value.bits = extend(left, false) != 0 ? extend(operands[1], isSigned) : extend(operands[2], isSigned);
+    } else if (symbol == ">" || symbol == "<" || symbol == "==") {
+        bool isSigned = left.isSigned && right.isSigned;
+        uint64_t a = extend(left, isSigned);
+        uint64_t b = extend(right, isSigned);
+        if (symbol == "==") {
+            value.bits = a == b;
+        } else if (isSigned) {
+            value.bits = symbol == ">" ? int64_t(a) > int64_t(b) : int64_t(a) < int64_t(b);
+        } else {
+            value.bits = symbol == ">" ? a > b : a < b;
+        }
+    } else if (symbol == "<<" || symbol == ">>") {
+        // The shift amount is always unsigned and sized by itself
+        uint64_t a = extend(left, left.isSigned) & mask(std::max(result.width, left.width));
+        uint64_t b = right.bits & mask(right.width);
+        value.bits = b >= 64 ? 0 : symbol == "<<" ? a << b : a >> b;
+    } else {
+        bool isSigned = left.isSigned && right.isSigned;
+        int context = std::max({result.width, left.width, right.width});
+        uint64_t a = extend(left, isSigned);
+        uint64_t b = extend(right, isSigned);
+        if (symbol == "+") {
+            value.bits = a + b;
+        } else if (symbol == "-") {
+            value.bits = a - b;
+        } else if (symbol == "*") {
+            value.bits = a * b;
+        } else if (symbol == "/" || symbol == "%") {
+            // Division by zero gives x
+            if ((b & mask(context)) == 0 || (isSigned && context == 64 && int64_t(a) == INT64_MIN && int64_t(b) == -1)) {
+                return false;
+            }
+            if (isSigned) {
+                value.bits = symbol == "/" ? int64_t(a) / int64_t(b) : int64_t(a) % int64_t(b);
+            } else {
+                a &= mask(context);
+                b &= mask(context);
+                value.bits = symbol == "/" ? a / b : a % b;
+            }
+        } else {
+            return false;
+        }
+    }
+    value.bits &= mask(value.width);
+    return true;
+}
+
+// The statement text of lowerOperation for the operation's current operands
+std::string operationLine(const Operation& operation) {
+    if (operation.opType == "MUX2x1") {
+        return operation.result + " <= " + operation.operands[0] + " ? " + operation.operands[1] + " : " + operation.operands[2] + ";";
+    }
+    return operation.result + " <= " + operation.operands[0] + " " + operation.symbol + " " + operation.operands[1] + ";";
+}
+
+class IrOptimizer {
+public:
+    IrOptimizer(std::vector<Operation>& operations, const SymbolTable& symbols) : operations(operations), symbols(symbols) {
+        this->index();
+    }
+
+    void numberValues(OptimizationReport& report);
+    void mergeBranchTails(OptimizationReport& report);
+    void removeDeadCode(OptimizationReport& report);
+
+private:
+    std::vector<Operation>& operations;
+    const SymbolTable& symbols;
+    std::vector<int> guards;                // IF guarding each operation, -1 at the top level
+    std::vector<std::vector<int>> writers;  // operations writing each symbol, except IFs and REGs (which get no node)
+    std::vector<std::vector<int>> readers;  // operations reading each symbol as an operand or condition
+    std::vector<char> removed;
+
+    void index();
+    void compact();
+    bool inArm(int index, int test, bool enter_branch) const;
+    bool covers(int outer, int inner) const;
+    bool encloses(int writer, int reader) const;
+    bool replaceReads(int writer, const std::string& name, int id);
+};
+
+void IrOptimizer::index() {
+    size_t count = this->operations.size();
+    this->guards.assign(count, -1);
+    this->writers.assign(this->symbols.size(), {});
+    this->readers.assign(this->symbols.size(), {});
+    this->removed.assign(count, 0);
+
+    // A branch body follows its IF, so the last IF testing a condition is the one guarding it
+    std::unordered_map<std::string, int> tests;
+    for (size_t index = 0; index < count; index++) {
+        const Operation& operation = this->operations[index];
+        if (!operation.condition.empty()) {
+            auto test = tests.find(operation.condition);
+            this->guards[index] = test == tests.end() ? -1 : test->second;
+        }
+        if (operation.opType == "IF") {
+            tests[operation.result] = index;
+        } else if (operation.opType != "REG" && operation.resultId != SymbolTable::npos) {
+            this->writers[operation.resultId].push_back(index);
+        }
+        for (int id : operation.operandIds) {
+            if (id != SymbolTable::npos) {
+                this->readers[id].push_back(index);
+            }
+        }
+        if (operation.conditionId != SymbolTable::npos) {
+            this->readers[operation.conditionId].push_back(index);
+        }
+    }
+}
+
+void IrOptimizer::compact() {
+    size_t kept = 0;
+    for (size_t index = 0; index < this->operations.size(); index++) {
+        if (this->removed[index]) {
+            continue;
+        }
+        if (kept != index) {
+            this->operations[kept] = std::move(this->operations[index]);
+        }
+        kept++;
+    }
+    this->operations.resize(kept);
+    this->index();
+}
+
+// Whether the operation sits, at any depth, in the given arm of the IF
+bool IrOptimizer::inArm(int index, int test, bool enter_branch) const {
+    bool side = this->operations[index].enter_branch;
+    for (int at = this->guards[index]; at >= 0; at = this->guards[at]) {
+        if (at == test) {
+            return side == enter_branch;
+        }
+        side = this->operations[at].enter_branch;
+    }
+    return false;
+}
+
+// Whether the operation at inner only runs when the one at outer does: it sits in outer's arm
+// and no condition outer is guarded by changes between the two
+bool IrOptimizer::covers(int outer, int inner) const {
+    int test = this->guards[outer];
+    if (test >= 0 && !this->inArm(inner, test, this->operations[outer].enter_branch)) {
+        return false;
+    }
+    int from = std::min(outer, inner);
+    int to = std::max(outer, inner);
+    for (; test >= 0; test = this->guards[test]) {
+        for (int other : this->writers[this->operations[test].resultId]) {
+            if (other > from && other < to && !this->removed[other]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Whether the writer has run, and its guards still hold, whenever the reader runs
+bool IrOptimizer::encloses(int writer, int reader) const {
+    return writer < reader && this->covers(writer, reader);
+}
+
+// Points the readers of the writer's result at the given constant or symbol,
+// and drops the writer; does nothing unless every reader sees the writer's value
+bool IrOptimizer::replaceReads(int writer, const std::string& name, int id) {
+    int result = this->operations[writer].resultId;
+    for (int reader : this->readers[result]) {
+        const Operation& operation = this->operations[reader];
+        if (this->removed[reader]) {
+            continue;
+        }
+        if (operation.opType == "IF" || operation.conditionId == result || !this->encloses(writer, reader)) {
+            return false;
+        }
+    }
+    for (int reader : this->readers[result]) {
+        Operation& operation = this->operations[reader];
+        for (size_t iter = 0; iter < operation.operands.size(); iter++) {
+            if (operation.operandIds[iter] == result) {
+                operation.operands[iter] = name;
+                operation.operandIds[iter] = id;
+            }
+        }
+        operation.line = operationLine(operation);
+        if (id != SymbolTable::npos) {
+            this->readers[id].push_back(reader);
+        }
+    }
+    this->readers[result].clear();
+    this->removed[writer] = 1;
+    return true;
+}
+
+void IrOptimizer::numberValues(OptimizationReport& report) {
+    // Equal numbers mean equal values wherever both operations run. A symbol has a number
+    // only while it is never written or once written where the reader is known to see it.
+    std::unordered_map<std::string, int> numbers;
+    std::unordered_map<int, Constant> constants;
+    std::unordered_map<int, std::vector<int>> holders;  // operations whose result alone holds each value
+    std::vector<int> values(this->operations.size(), -1);
+    int next = 0;
+    auto number = [&numbers, &next](const std::string& key) {
+        auto found = numbers.emplace(key, next);
+        next += found.second ? 1 : 0;
+        return found.first->second;
+    };
+
+    auto operandValue = [&](int index, size_t iter) {
+        const Operation& operation = this->operations[index];
+        int id = operation.operandIds[iter];
+        if (id == SymbolTable::npos) {
+            Constant literal;
+            if (!parseLiteral(operation.operands[iter], literal)) {
+                return operation.operands[iter].empty() ? number("") : next++;
+            }
+            int value = number("#" + formatLiteral(literal));
+            constants[value] = literal;
+            return value;
+        }
+        std::vector<int> written;
+        for (int writer : this->writers[id]) {
+            if (!this->removed[writer]) {
+                written.push_back(writer);
+            }
+        }
+        if (written.empty()) {
+            return number("$" + std::to_string(id));
+        }
+        if (written.size() == 1 && values[written[0]] >= 0 && this->encloses(written[0], index)) {
+            return values[written[0]];
+        }
+        return next++;
+    };
+
+    for (int index = 0; index < static_cast<int>(this->operations.size()); index++) {
+        const Operation& operation = this->operations[index];
+        if (this->removed[index] || operation.opType == "IF" || operation.symbol.empty() || operation.resultId == SymbolTable::npos) {
+            continue;
+        }
+        const Component& result = this->symbols[operation.resultId];
+        std::string key = operation.symbol;
+        std::vector<Constant> operands;
+        bool known = true;
+        for (size_t iter = 0; iter < operation.operands.size(); iter++) {
+            int value = operandValue(index, iter);
+            key += "|" + std::to_string(value);
+            int id = operation.operandIds[iter];
+            if (id != SymbolTable::npos) {
+                key += ":" + std::to_string(this->symbols[id].width) + (this->symbols[id].isSigned ? "s" : "u");
+            }
+            auto constant = constants.find(value);
+            known = known && constant != constants.end();
+            if (known) {
+                operands.push_back(constant->second);
+            }
+        }
+        key += "|" + std::to_string(result.width) + (result.isSigned ? "s" : "u");
+
+        Constant folded;
+        bool isConstant = known && foldOperation(operation.symbol, operands, result, folded);
+        int value = isConstant ? number("#" + formatLiteral(folded)) : number(key);
+        if (isConstant) {
+            constants[value] = folded;
+        }
+        values[index] = value;
+
+        std::vector<int> written;
+        for (int writer : this->writers[operation.resultId]) {
+            if (!this->removed[writer]) {
+                written.push_back(writer);
+            }
+        }
+        if (written.size() > 1) {
+            // Writing the value the result already holds changes nothing
+            auto self = std::find(written.begin(), written.end(), index);
+            if (self != written.begin() && values[*(self - 1)] == value && this->encloses(*(self - 1), index)) {
+                this->removed[index] = 1;
+                report.common++;
+            }
+            continue;
+        }
+        // Outputs and inputs keep their writes; temporaries and variables can be read elsewhere
+        if (result.type == "variable") {
+            if (isConstant && this->replaceReads(index, formatLiteral(folded), SymbolTable::npos)) {
+                report.folded++;
+                continue;
+            }
+            bool replaced = false;
+            for (int holder : holders[value]) {
+                if (this->encloses(holder, index) && this->replaceReads(index, this->operations[holder].result, this->operations[holder].resultId)) {
+                    replaced = true;
+                    break;
+                }
+            }
+            if (replaced) {
+                report.common++;
+                continue;
+            }
+        }
+        holders[value].push_back(index);
+    }
+    this->compact();
+}
+
+void IrOptimizer::mergeBranchTails(OptimizationReport& report) {
+    auto mergeable = [](const Operation& operation) {
+        return operation.opType != "IF" && !operation.symbol.empty() && operation.resultId != SymbolTable::npos;
+    };
+    auto statement = [](const Operation& operation) {
+        std::string key = operation.opType + "|" + operation.line;
+        for (int id : operation.operandIds) {
+            key += "|" + std::to_string(id);
+        }
+        return key;
+    };
+
+    int count = this->operations.size();
+    for (int test = 0; test < count; test++) {
+        const Operation& branch = this->operations[test];
+        if (branch.opType != "IF" || !branch.condition.empty()) {
+            continue;
+        }
+        int end = test;
+        while (end + 1 < count && (this->inArm(end + 1, test, true) || this->inArm(end + 1, test, false))) {
+            end++;
+        }
+        std::unordered_map<std::string, int> otherwise;
+        for (int index = test + 1; index <= end; index++) {
+            if (this->guards[index] == test && !this->operations[index].enter_branch && mergeable(this->operations[index])) {
+                otherwise.emplace(statement(this->operations[index]), index);
+            }
+        }
+
+        // The same statement in both arms moves after the if when nothing later in either arm
+        // touches its operands or result, and nothing outside the if writes or reads them early
+        auto safe = [&](int first, int second) {
+            const Operation& operation = this->operations[first];
+            for (int writer : this->writers[operation.resultId]) {
+                if (writer != first && writer != second && !this->removed[writer]) {
+                    return false;
+                }
+            }
+            for (int reader : this->readers[operation.resultId]) {
+                if (reader <= end && !this->removed[reader]) {
+                    return false;
+                }
+            }
+            for (int id : operation.operandIds) {
+                if (id == SymbolTable::npos) {
+                    continue;
+                }
+                for (int writer : this->writers[id]) {
+                    if (writer >= first && !(writer < second && !this->inArm(writer, test, true)) && !this->removed[writer]) {
+                        return false;
+                    }
+                }
+            }
+            for (int writer : this->writers[branch.resultId]) {
+                if (writer > test && writer <= end) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        for (int index = test + 1; index <= end; index++) {
+            const Operation& operation = this->operations[index];
+            if (this->guards[index] != test || !operation.enter_branch || !mergeable(operation)) {
+                continue;
+            }
+            auto other = otherwise.find(statement(operation));
+            if (other == otherwise.end() || !safe(index, other->second)) {
+                continue;
+            }
+            Operation& merged = this->operations[other->second];
+            merged.condition.clear();
+            merged.conditionId = SymbolTable::npos;
+            merged.isBranch = false;
+            merged.enter_branch = false;
+            this->guards[other->second] = -1;
+            this->removed[index] = 1;
+            otherwise.erase(other);
+            report.common++;
+        }
+        test = end;
+    }
+    this->compact();
+}
+
+void IrOptimizer::removeDeadCode(OptimizationReport& report) {
+    // A write is dead when a later write that runs whenever it does comes before any read
+    for (size_t id = 0; id < this->symbols.size(); id++) {
+        const std::vector<int>& written = this->writers[id];
+        const std::vector<int>& read = this->readers[id];
+        for (size_t iter = 0; iter + 1 < written.size(); iter++) {
+            auto next = std::upper_bound(read.begin(), read.end(), written[iter]);
+            for (size_t later = iter + 1; later < written.size(); later++) {
+                if (next != read.end() && *next <= written[later]) {
+                    break;
+                }
+                if (this->covers(written[later], written[iter])) {
+                    this->removed[written[iter]] = 1;
+                    report.dead++;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<char> live(this->operations.size(), 0);
+    std::vector<char> liveSymbols(this->symbols.size(), 0);
+    std::vector<int> work;
+    auto markOperation = [&live, &work](int index) {
+        if (index >= 0 && !live[index]) {
+            live[index] = 1;
+            work.push_back(index);
+        }
+    };
+    auto markSymbol = [this, &liveSymbols, &markOperation](int id) {
+        if (id != SymbolTable::npos && !liveSymbols[id]) {
+            liveSymbols[id] = 1;
+            for (int writer : this->writers[id]) {
+                if (!this->removed[writer]) {
+                    markOperation(writer);
+                }
+            }
+        }
+    };
+
+    for (size_t id = 0; id < this->symbols.size(); id++) {
+        if (this->symbols[id].type == "output") {
+            markSymbol(id);
+        }
+    }
+    for (size_t index = 0; index < this->operations.size(); index++) {
+        if (this->operations[index].opType == "REG" || this->operations[index].resultId == SymbolTable::npos) {
+            markOperation(index);
+        }
+    }
+    // A live operation keeps its operands, its condition and the IFs it sits in
+    while (!work.empty()) {
+        int index = work.back();
+        work.pop_back();
+        const Operation& operation = this->operations[index];
+        for (int id : operation.operandIds) {
+            markSymbol(id);
+        }
+        markSymbol(operation.conditionId);
+        markOperation(this->guards[index]);
+    }
+
+    for (size_t index = 0; index < this->operations.size(); index++) {
+        if (!live[index] && !this->removed[index]) {
+            this->removed[index] = 1;
+            report.dead++;
+        }
+    }
+    this->compact();
+}
+
+} // namespace
+
+OptimizationReport optimizeOperations(NetlistParser& parser) {
+    OptimizationReport report;
+    report.operations = parser.getOperations().size();
+    IrOptimizer optimizer(parser.getOperations(), parser.getSymbols());
+    optimizer.numberValues(report);
+    optimizer.mergeBranchTails(report);
+    optimizer.removeDeadCode(report);
+    return report;
+}
@@ -0,0 +1,34 @@
+#ifndef IROPTIMIZER_H
+#define IROPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "NetlistParser.h"
+
+// Operations removed by optimizeOperations, per pass
+struct OptimizationReport {
+    int64_t operations = 0;  // operations before optimizing
+    int64_t folded = 0;      // constant results, their readers use the value instead
+    int64_t common = 0;      // recomputed values and statements repeated at the end of both arms of an if
+    int64_t dead = 0;        // overwritten writes, results that never reach an output and empty ifs
+
+    int64_t removed() const { return folded + common + dead; }
+};
+
+// Optimizes the parsed operations in place, before OpPostProcess builds the graph:
+//
+//  1. Value numbering in program order. An operation whose operands are all constants is
+//     folded, and one computing the value of an earlier operation is dropped; the readers of
+//     its result then read the constant (as a sized literal) or the earlier result instead.
+//     Only a result written once, read after that write and only where the write is known to
+//     have run, is replaced, so the earlier result is the one write each reader can see.
+//  2. A statement closing both arms of a top-level if is done once after the if.
+//  3. A write overwritten before any read is removed. So are operations whose results do not
+//     reach an output, directly or through a condition of a live operation, and ifs with
+//     nothing left to guard.
+//
+// Operations keep their names and order, so the names of the remaining nodes do not change.
+OptimizationReport optimizeOperations(NetlistParser& parser);
+
+#endif // IROPTIMIZER_H
@@ -0,0 +1,117 @@
+#include "NetlistLexer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filePath) {
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        size = info.st_size;
+        if (size == 0) {
+            opened = true;
+        } else {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const char*>(mapping);
+                opened = true;
+            }
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+namespace {
+
+bool isWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Two-character operators; everything else is a single character
+bool isDoubleSymbol(char first, char second) {
+    return (first == '=' && second == '=') || (first == '<' && second == '<') || (first == '>' && second == '>') ||
+           (first == '<' && second == '=') || (first == '>' && second == '=') || (first == '!' && second == '=');
+}
+
+bool isSymbol(char c) {
+    switch (c) {
+        case '=': case '+': case '-': case '*': case '/': case '%': case '<': case '>':
+        case '?': case ':': case ';': case ',': case '(': case ')': case '{': case '}': case '!':
+            return true;
+        default:
+            return false;
+    }
+}
+
+}
+
+NetlistLexer::NetlistLexer(std::string_view source) : source(source) {}
+
+bool NetlistLexer::nextLine(std::vector<Token>& tokens, std::string_view& lineText) {
+    tokens.clear();
+    if (position >= source.size()) {
+        return false;
+    }
+
+    size_t lineStart = position;
+    size_t lineEnd = source.find('\n', lineStart);
+    if (lineEnd == std::string_view::npos) {
+        lineEnd = source.size();
+    }
+    position = lineEnd + 1;
+    lineNumber++;
+
+    size_t commentPos = source.substr(lineStart, lineEnd - lineStart).find("//");
+    if (commentPos != std::string_view::npos) {
+        lineEnd = lineStart + commentPos;
+    }
+
+    size_t iter = lineStart;
+    while (iter < lineEnd) {
+        char c = source[iter];
+        if (isSpace(c)) {
+            iter++;
+            continue;
+        }
+        size_t start = iter;
+        TokenKind kind;
+        if (isWordChar(c)) {
+            while (iter < lineEnd && isWordChar(source[iter])) {
+                iter++;
+            }
+            kind = TokenKind::Word;
+        } else if (iter + 1 < lineEnd && isDoubleSymbol(c, source[iter + 1])) {
+            iter += 2;
+            kind = TokenKind::Symbol;
+        } else {
+            iter++;
+            kind = isSymbol(c) ? TokenKind::Symbol : TokenKind::Invalid;
+        }
+        tokens.push_back({kind, source.substr(start, iter - start), lineNumber, static_cast<int>(start - lineStart) + 1});
+    }
+
+    // Trim the surrounding whitespace from the line for diagnostics
+    while (lineStart < lineEnd && isSpace(source[lineStart])) {
+        lineStart++;
+    }
+    while (lineEnd > lineStart && isSpace(source[lineEnd - 1])) {
+        lineEnd--;
+    }
+    lineText = source.substr(lineStart, lineEnd - lineStart);
+    return true;
+}
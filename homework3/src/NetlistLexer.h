@@ -0,0 +1,63 @@
+#ifndef NETLISTLEXER_H
+#define NETLISTLEXER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only memory mapping of an input file, so the lexer can hand out views into it
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    std::string_view contents() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool opened = false;
+};
+
+enum class TokenKind {
+    Word,     // identifiers, keywords, type names and numbers
+    Symbol,   // operators and punctuation
+    Invalid   // any other character
+};
+
+// A token is a view into the source; line and column are 1-based
+struct Token {
+    TokenKind kind;
+    std::string_view text;
+    int line;
+    int column;
+
+    bool is(std::string_view value) const { return text == value; }
+};
+
+// Splits the source into lines (the netlist has one statement per line) and each line into
+// tokens, dropping whitespace and // comments. Tokens and lines point into the source buffer.
+class NetlistLexer {
+public:
+    explicit NetlistLexer(std::string_view source);
+
+    // Tokenizes the next line into tokens (cleared first) and sets lineText to the line
+    // without its comment; returns false once the source is exhausted
+    bool nextLine(std::vector<Token>& tokens, std::string_view& lineText);
+
+private:
+    std::string_view source;
+    size_t position = 0;
+    int lineNumber = 0;
+};
+
+// Source text from the start of the first token to the end of the last one
+inline std::string_view tokenSpan(const Token& first, const Token& last) {
+    return std::string_view(first.text.data(), last.text.data() + last.text.size() - first.text.data());
+}
+
+#endif // NETLISTLEXER_H
@@ -1,52 +1,79 @@
 #include "NetlistParser.h"
+#include "hls_error.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
-#include <regex>
+#include <charconv>
 
 NetlistParser::NetlistParser(const std::string& filePath) : filePath(filePath) {}
 
 void NetlistParser::parse() {
-    std::ifstream file(filePath);
-    std::string line;
-    while (getline(file, line)) {
-        parseLine(line);
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        throw HlsError("Error: Unable to read netlist file '" + filePath + "'");
+    }
+    this->parseSource(file.contents());
+}
+
+void NetlistParser::parseSource(std::string_view source) {
+    NetlistLexer lexer(source);
+    std::vector<Token> lineTokens;
+    std::string_view line;
+    lines.push_back(std::string_view()); // Token line numbers are 1-based
+    while (lexer.nextLine(lineTokens, line)) {
+        lines.push_back(line);
+        tokens.insert(tokens.end(), lineTokens.begin(), lineTokens.end());
+    }
+
+    // program := { declaration | statement }
+    BranchScope topLevel;
+    try {
+        while (!atEnd()) {
+            parseStatement(topLevel);
+        }
+    } catch (...) {
+        releaseSource();
+        throw;
     }
+    releaseSource();
             // After processing all operations
             
-    for (auto& component : components) {
+    for (int id = 0; id < static_cast<int>(symbols.size()); id++) {
         // Check if the component is an output and hasn't been registered
-        if (component.type == "output" && !component.isReg) {
+        if (symbols[id].type == "output" && !symbols[id].isReg) {
             // Check if the wire component already exists
-            std::string wireOperand = component.name + "wire";
-            bool wireExists = std::any_of(components.begin(), components.end(), [&](const Component& comp) { return comp.name == wireOperand; });
+            std::string wireOperand = symbols[id].name + "wire";
+            int wireId = symbols.find(wireOperand);
 
             // If the wire component doesn't exist, add it to the components
-            if (!wireExists) {
+            if (wireId == SymbolTable::npos) {
                 Component wireComponent;
                 wireComponent.type = "wire";
                 wireComponent.name = wireOperand;
-                wireComponent.width = component.width; // Set the width according to the component
-                wireComponent.isSigned = component.isSigned; // Set the signedness according to the component
+                wireComponent.width = symbols[id].width; // Set the width according to the component
+                wireComponent.isSigned = symbols[id].isSigned; // Set the signedness according to the component
                 wireComponent.isNew = true;
-                components.push_back(wireComponent);
+                wireId = symbols.add(wireComponent);
 
                 #if defined(ENABLE_LOGGING)  
-                std::cout << "Declared wire component: " << wireOperand << " with width " << component.width << (component.isSigned ? ", signed" : ", unsigned") << "\n";
+                std::cout << "Declared wire component: " << wireOperand << " with width " << symbols[id].width << (symbols[id].isSigned ? ", signed" : ", unsigned") << "\n";
                 #endif 
             }
+            const Component& component = symbols[id];
 
             // Add a registration operation for the output component
             Operation regOperation;
             regOperation.result = component.name;
+            regOperation.resultId = id;
             regOperation.operands.push_back(wireOperand);
+            regOperation.operandIds.push_back(wireId);
             regOperation.opType = "REG";
             regOperation.width = component.width; // Set the width according to the component
             regOperation.isSigned = component.isSigned; // Set the signedness according to the component
             operations.push_back(regOperation);
 
             // Set the isReg flag for the output component
-            component.isReg = true;
+            symbols[id].isReg = true;
             // Replace other operations using the output as an operand with the new wire         
         }
  
@@ -54,29 +81,38 @@ void NetlistParser::parse() {
  
     // Replace operands in operations with the new wire if necessary
     for (auto& operation : operations) {
-        for (auto& operand : operation.operands) {
+        for (size_t iter = 0; iter < operation.operands.size(); iter++) {
             // Check if operand matches any output component that has been registered
-            auto it = std::find_if(components.begin(), components.end(), [&](const Component& comp) {
-                return comp.name == operand && comp.type == "output" && comp.isReg;
-            });
-
-            if (it != components.end()) {
+            int id = operation.operandIds[iter];
+            if (id != SymbolTable::npos && symbols[id].type == "output" && symbols[id].isReg) {
                 // If found, replace the operand with its corresponding wire
-                std::string wireOperand = it->name + "wire";
-                operand = wireOperand;
-                std::cerr << "Multi-driven pin detected and resolved for " << it->name << ". Replaced with " << wireOperand << std::endl;
+                std::string wireOperand = symbols[id].name + "wire";
+                operation.operands[iter] = wireOperand;
+                operation.operandIds[iter] = symbols.find(wireOperand);
+                std::string warning = "Multi-driven pin detected and resolved for " + symbols[id].name + ". Replaced with " + wireOperand;
+                if (std::find(warnings.begin(), warnings.end(), warning) == warnings.end()) {
+                    warnings.push_back(warning);
+                }
             }
         }
     }
     #if defined(ENABLE_LOGGING)  
-    for (const auto& component : components) {
+    for (const auto& component : symbols.entries()) {
         std::cout << "Component: " << component.name << ", isReg: " << (component.isReg ? "true" : "false") << std::endl;
     }
     #endif       
 }
-bool isNumeric(const std::string& str);
-bool isExactlyOne(const std::string& str);  
-bool isOnlyWhitespace(const std::string& str);
+// Tokens and lines view the source text, which the caller may release once parsing returns
+void NetlistParser::releaseSource() {
+    tokens.clear();
+    lines.clear();
+    expression.clear();
+    cursor = 0;
+}
+
+bool isNumeric(std::string_view str);
+bool isExactlyOne(std::string_view str);  
+bool isOnlyWhitespace(std::string_view str);
 void trim(std::string &s);
 #include <fstream>
 #include <sstream>
@@ -141,66 +177,342 @@ void NetlistParser::modifyModuleName(std::string& moduleName) {
 }*/
 
 
-int NetlistParser::determineOperationWidth(const std::string& opType, const std::vector<std::string>& operands, const std::string& result) {
+int NetlistParser::determineOperationWidth(const Operation& operation) {
     int maxWidth = 0;
 
-    if (opType == "COMP") {
-        // Determine the maximum width among operands
-        for (const auto& operand : operands) {
-            if (isNumeric(operand) || isOnlyWhitespace(operand)) continue; // Skip constants or empty operands
-
-            if (componentWidths.find(operand) != componentWidths.end()) {
-                int width = componentWidths[operand];
-                maxWidth = std::max(maxWidth, width);
-            } else {
-                std::cerr << "Error: Operand " << operand << " not found.\n";
-                std::exit(EXIT_FAILURE); // Exit if an operand width cannot be determined.
+    if (operation.opType == "COMP") {
+        // Determine the maximum width among operands; constants and empty operands have no symbol
+        for (int id : operation.operandIds) {
+            if (id != SymbolTable::npos) {
+                maxWidth = std::max(maxWidth, symbols[id].width);
             }
         }
     } else {
         // Determine the width based on the result
-        if (componentWidths.find(result) != componentWidths.end()) {
-            maxWidth = componentWidths[result];
+        if (operation.resultId != SymbolTable::npos) {
+            maxWidth = symbols[operation.resultId].width;
         } else {
-            std::cerr << "Error: Result " << result << " not found.\n";
-            std::exit(EXIT_FAILURE); // Exit if the result width cannot be determined.
+            throw HlsError("Error: Result " + operation.result + " not found."); // The result width cannot be determined.
         }
     }
 
     return maxWidth;
 }
 
-bool isValidOperand(const std::string& operand, const std::vector<Component>& components) {
-    // Check if the operand is a constant or whitespace
-    if (isNumeric(operand) || isOnlyWhitespace(operand))
+const Token& NetlistParser::peek() const {
+    static const Token endOfFile = {TokenKind::Invalid, std::string_view(), 0, 0};
+    return cursor < tokens.size() ? tokens[cursor] : endOfFile;
+}
+
+bool NetlistParser::atEnd() const {
+    return cursor >= tokens.size();
+}
+
+bool NetlistParser::accept(std::string_view text) {
+    if (!atEnd() && tokens[cursor].is(text)) {
+        cursor++;
         return true;
+    }
+    return false;
+}
 
-    // Check if the operand is inside the components
-    for (const auto& component : components) {
-        if (operand == component.name)
-            return true;
+const Token& NetlistParser::expect(std::string_view text) {
+    if (!accept(text)) {
+        syntaxError(peek(), "Expected '" + std::string(text) + "'");
     }
+    return tokens[cursor - 1];
+}
 
-    // Operand is neither constant, whitespace, nor inside components
-    return false;
+void NetlistParser::syntaxError(const Token& at, const std::string& message) const {
+    if (at.line == 0) {
+        throw HlsError("Error: " + message + " at end of file");
+    }
+    throw HlsError("Error: " + message + " at line " + std::to_string(at.line) + ", column " + std::to_string(at.column) + " in line: " + std::string(lines[at.line]));
+}
+
+// Symbol of an operand token; constants have no symbol, undeclared names are an error
+Operand NetlistParser::resolveOperand(const Token& operand) const {
+    if (isNumeric(operand.text)) {
+        return {std::string(operand.text), SymbolTable::npos};
+    }
+    int id = operand.kind == TokenKind::Word ? symbols.find(operand.text) : SymbolTable::npos;
+    if (id == SymbolTable::npos) {
+        syntaxError(operand, "Invalid operand '" + std::string(operand.text) + "'");
+    }
+    return {std::string(operand.text), id};
+}
+
+void NetlistParser::parseStatement(const BranchScope& scope) {
+    const Token& word = peek();
+    if (word.is("input") || word.is("output") || word.is("wire") || word.is("variable")) {
+        parseDeclaration();
+    } else if (word.is("if")) {
+        parseIf(scope);
+    } else if (word.kind == TokenKind::Word && cursor + 1 < tokens.size() && tokens[cursor + 1].is("=")) {
+        parseAssignment(scope);
+    } else {
+        syntaxError(word, "Unexpected '" + std::string(word.text) + "'");
+    }
 }
-std::unordered_map<int, std::string> lastNodeNameByState;
 
-void NetlistParser::parseBranch(const std::string& branch_type,const std::string& self_condition, const std::string& prev_condition, bool enter_branch, int order, int prev_order) {
+// declaration := ('input' | 'output' | 'wire' | 'variable') Type name { ',' name }
+void NetlistParser::parseDeclaration() {
+    const Token& word = tokens[cursor++];
+    const Token& type = peek();
+    std::string_view dataType = type.text;
+    // Check data type validity
+    size_t digits = dataType.substr(0, 3) == "Int" ? 3 : (dataType.substr(0, 4) == "UInt" ? 4 : dataType.size());
+    if (digits >= dataType.size() || !std::all_of(dataType.begin() + digits, dataType.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        syntaxError(type, "Data type must be 'Int' or 'UInt', found '" + std::string(dataType) + "'");
+    }
+    cursor++;
+    int width = 0;
+    std::from_chars(dataType.data() + digits, dataType.data() + dataType.size(), width);
+
+    bool isSigned = digits == 3;
+
+    do {
+        const Token& name = peek();
+        if (name.kind != TokenKind::Word) {
+            syntaxError(name, "Invalid component name '" + std::string(name.text) + "'");
+        }
+        cursor++;
+        Component component;
+        component.type = std::string(word.text);
+        if(component.type == "variable") component.isReg = true;
+        component.name = std::string(name.text);
+        component.width = width;
+        if(width == 1) component.isSigned = false;
+        else component.isSigned = isSigned;
+        component.declaredSigned = isSigned;
+        symbols.add(component);
+        #if defined(ENABLE_LOGGING)
+        std::cout << "Parsed " << word.text << ": " << component.name << " with width " << width << (component.isSigned ? ", signed" : ", unsigned") << "\n";
+        #endif
+    } while (accept(","));
+    accept(";");
+}
+
+// if := 'if' '(' expression ')' block [ 'else' ( if | block ) ]
+void NetlistParser::parseIf(const BranchScope& scope) {
+    const Token& keyword = tokens[cursor++];
+    expect("(");
+    expression.clear();
+    int root = parseExpression();
+    expect(")");
+
+    // A compound condition is computed into a temporary before the branch
+    const ExpressionNode& node = expression[root];
+    Operand condition;
+    if (node.left < 0) {
+        condition = resolveOperand(*node.token);
+        if (condition.id == SymbolTable::npos) {
+            syntaxError(*node.token, "Condition must be a variable or an expression");
+        }
+    } else {
+        condition = lowerOperand(root, expressionWidth(root), scope);
+    }
+    parseBranch("IF", condition, scope);
+    #if defined(ENABLE_LOGGING)
+    std::cout << "Entering IF block at line " << keyword.line << ", condition: " << condition.name << std::endl;
+    #else
+    (void)keyword;
+    #endif
+
+    BranchScope body;
+    body.condition = condition;
+    body.enter_branch = true;
+    body.isBranch = true;
+    parseBlock(body);
+
+    if (accept("else")) {
+        BranchScope otherwise = body;
+        otherwise.enter_branch = false;
+        if (peek().is("if")) {
+            parseIf(otherwise);
+        } else {
+            parseBlock(otherwise);
+        }
+    }
+}
+
+// block := '{' { statement } '}' | statement
+void NetlistParser::parseBlock(const BranchScope& scope) {
+    if (!accept("{")) {
+        parseStatement(scope);
+        return;
+    }
+    while (!accept("}")) {
+        if (atEnd()) {
+            syntaxError(peek(), "Expected '}'");
+        }
+        parseStatement(scope);
+    }
+}
+
+// assignment := name '=' expression [';']
+void NetlistParser::parseAssignment(const BranchScope& scope) {
+    const Token& target = tokens[cursor];
+    cursor += 2;
+    expression.clear();
+    int root = parseExpression();
+    accept(";");
+
+    Operand result = resolveOperand(target);
+    lowerAssignment(result, root, result.id == SymbolTable::npos ? 0 : symbols[result.id].width, scope);
+}
+
+// expression := binary [ '?' expression ':' expression ]
+int NetlistParser::parseExpression() {
+    int condition = parseBinary(0);
+    if (peek().is("?")) {
+        const Token* symbol = &tokens[cursor++];
+        int whenTrue = parseExpression();
+        expect(":");
+        int whenFalse = parseExpression();
+        expression.push_back({symbol, condition, whenTrue, whenFalse});
+        return expression.size() - 1;
+    }
+    return condition;
+}
+
+// Binary operators from the loosest to the tightest binding level, all left associative
+int NetlistParser::parseBinary(int level) {
+    static const std::vector<std::vector<std::string_view>> levels = {
+        {"==", "!="},
+        {"<", ">", "<=", ">="},
+        {"<<", ">>"},
+        {"+", "-"},
+        {"*", "/", "%"},
+    };
+    if (level == static_cast<int>(levels.size())) {
+        return parsePrimary();
+    }
+    int left = parseBinary(level + 1);
+    while (!atEnd() && tokens[cursor].kind == TokenKind::Symbol &&
+           std::find(levels[level].begin(), levels[level].end(), tokens[cursor].text) != levels[level].end()) {
+        const Token* symbol = &tokens[cursor++];
+        int right = parseBinary(level + 1);
+        expression.push_back({symbol, left, right, -1});
+        left = expression.size() - 1;
+    }
+    return left;
+}
+
+// primary := name | number | '(' expression ')'
+int NetlistParser::parsePrimary() {
+    if (accept("(")) {
+        int inner = parseExpression();
+        expect(")");
+        return inner;
+    }
+    const Token& operand = peek();
+    if (operand.kind != TokenKind::Word) {
+        syntaxError(operand, "Expected an operand");
+    }
+    cursor++;
+    expression.push_back({&operand, -1, -1, -1});
+    return expression.size() - 1;
+}
+
+// Widest symbol in the expression; comparisons produce a single bit
+int NetlistParser::expressionWidth(int index) const {
+    const ExpressionNode& node = expression[index];
+    if (node.left < 0) {
+        int id = symbols.find(node.token->text);
+        return id == SymbolTable::npos ? 0 : symbols[id].width;
+    }
+    std::string_view symbol = node.token->text;
+    if (symbol == "==" || symbol == "!=" || symbol == "<" || symbol == ">" || symbol == "<=" || symbol == ">=") {
+        return 1;
+    }
+    if (symbol == "?") {
+        return std::max(expressionWidth(node.right), expressionWidth(node.otherwise));
+    }
+    return std::max(expressionWidth(node.left), expressionWidth(node.right));
+}
+
+bool NetlistParser::expressionSigned(int index) const {
+    const ExpressionNode& node = expression[index];
+    if (node.left < 0) {
+        int id = symbols.find(node.token->text);
+        return id != SymbolTable::npos && symbols[id].declaredSigned;
+    }
+    return expressionSigned(node.left) || expressionSigned(node.right) || (node.otherwise >= 0 && expressionSigned(node.otherwise));
+}
+
+// Emits the operations computing the expression into result, inner nodes first
+void NetlistParser::lowerAssignment(const Operand& result, int index, int width, const BranchScope& scope) {
+    const ExpressionNode& node = expression[index];
+    if (node.left < 0) {
+        lowerOperation(result, "", resolveOperand(*node.token), Operand(), Operand(), *node.token, scope);
+        return;
+    }
+    // A comparison works at the width of its operands, not at that of its one-bit result,
+    // and compares signed if either side is signed; so does the condition of a '?'
+    std::string symbol(node.token->text);
+    bool compare = symbol == "==" || symbol == "!=" || symbol == "<" || symbol == ">" || symbol == "<=" || symbol == ">=";
+    int operandWidth = compare ? std::max(expressionWidth(node.left), expressionWidth(node.right)) : width;
+    bool operandSigned = compare && (expressionSigned(node.left) || expressionSigned(node.right));
+    Operand left = lowerOperand(node.left, symbol == "?" ? expressionWidth(node.left) : operandWidth, scope, operandSigned);
+    Operand right = lowerOperand(node.right, operandWidth, scope, operandSigned);
+    Operand otherwise = node.otherwise >= 0 ? lowerOperand(node.otherwise, width, scope) : Operand();
+    if (symbol == "!=" || symbol == "<=" || symbol == ">=") {
+        // Comparators only test ==, < and >: test the opposite and check that bit is 0
+        Operand opposite = declareTemporary(1, false);
+        lowerOperation(opposite, symbol == "!=" ? "==" : symbol == "<=" ? ">" : "<", left, right, Operand(), *node.token, scope);
+        lowerOperation(result, "==", opposite, {"0", SymbolTable::npos}, Operand(), *node.token, scope);
+        return;
+    }
+    lowerOperation(result, symbol, left, right, otherwise, *node.token, scope);
+}
+
+// Operand for a subexpression: leaves are used directly, inner nodes go through a temporary
+Operand NetlistParser::lowerOperand(int index, int width, const BranchScope& scope, bool isSigned) {
+    const ExpressionNode& node = expression[index];
+    if (node.left < 0) {
+        return resolveOperand(*node.token);
+    }
+    int tempWidth = expressionWidth(index) == 1 ? 1 : std::max(width, 1);
+    Operand temporary = declareTemporary(tempWidth, isSigned || expressionSigned(index));
+    lowerAssignment(temporary, index, tempWidth, scope);
+    return temporary;
+}
+
+Operand NetlistParser::declareTemporary(int width, bool isSigned) {
+    Component component;
+    do {
+        component.name = "_t" + std::to_string(temporaries++);
+    } while (symbols.find(component.name) != SymbolTable::npos);
+    component.type = "variable";
+    component.width = width;
+    component.isSigned = width > 1 && isSigned;
+    component.declaredSigned = isSigned;
+    component.isReg = true;
+    component.isNew = true;
+    int id = symbols.add(component);
+    return {component.name, id};
+}
+
+void NetlistParser::parseBranch(const std::string& branch_type, const Operand& self_condition, const BranchScope& scope) {
 
     Operation operation;
-    operation.condition = prev_condition;
-    operation.result = self_condition;
-    operation.operands.push_back(self_condition);
+    operation.condition = scope.condition.name;
+    operation.conditionId = scope.condition.id;
+    operation.result = self_condition.name;
+    operation.resultId = self_condition.id;
+    operation.operands.push_back(self_condition.name);
+    operation.operandIds.push_back(self_condition.id);
     operation.opType = branch_type;
     // Here you might want to call determineOperationWidth or assign a width directly
-    operation.order = order;
-    operation.prev_order = prev_order;
-    std::string nodeName = operation.opType + " v(" + std::to_string(order)+")"; // Construct a unique node name/id
-    operation.enter_branch = enter_branch;
+    operation.order = order++;
+    operation.prev_order = prev_order++;
+    std::string nodeName = operation.opType + " v(" + std::to_string(operation.order)+")"; // Construct a unique node name/id
+    // A nested branch records which side of the enclosing one it sits on
+    operation.enter_branch = scope.isBranch ? scope.enter_branch : true;
     operation.name = nodeName;
     if (operation.opType == "IF")
-        operation.line = std::string("if") + " (" +  operation.result + ")" ;     
+        operation.line = std::string("if") + " (" +  operation.result + ")" ;
     operations.push_back(operation);
 
 
@@ -209,35 +521,22 @@ void NetlistParser::parseBranch(const std::string& branch_type,const std::string
 
 
 
-void NetlistParser::parseOperation(const std::string& operationLine,const std::string& condition,bool enter_branch, bool isBranch, int order, int prev_order) {
-    std::string beforeEq = operationLine.substr(0, operationLine.find('='));
-    std::string afterEq = operationLine.substr(operationLine.find('=') + 1);
-
-    std::string result = beforeEq.substr(0, beforeEq.find(' '));
-    std::istringstream afterEqStream(afterEq);
-
-    std::string leftOperand, opSymbol, rightOperand, colon, mux_right;
-    afterEqStream >> leftOperand >> opSymbol >> rightOperand >> colon >> mux_right;
-
-    // Check if operands are valid
-    if (!isValidOperand(leftOperand, components) || !isValidOperand(result, components) || !isValidOperand(rightOperand, components) || !isValidOperand(mux_right, components)) {
-        std::cerr << "Error: Invalid operand in line: " << operationLine << "\n";
-        std::exit(EXIT_FAILURE);
-    }
-
-    // Remove semicolon if present in rightOperand
-    if (!rightOperand.empty() && rightOperand.back() == ';')
-        rightOperand.pop_back();
-    if (!mux_right.empty() && mux_right.back() == ';')
-        mux_right.pop_back();
+void NetlistParser::lowerOperation(const Operand& result, const std::string& opSymbol, const Operand& left, const Operand& right, const Operand& mux, const Token& at, const BranchScope& scope) {
+    const std::string& leftOperand = left.name;
+    const std::string& rightOperand = right.name;
+    const std::string& mux_right = mux.name;
+    std::string colon = opSymbol == "?" ? ":" : "";
 
     Operation operation;
-    operation.result = result;
+    operation.result = result.name;
+    operation.resultId = result.id;
     operation.operands.push_back(leftOperand);
     operation.operands.push_back(rightOperand);
+    operation.operandIds.push_back(left.id);
+    operation.operandIds.push_back(right.id);
     operation.symbol = opSymbol;
-    operation.enter_branch = enter_branch;
-    operation.isBranch = isBranch;
+    operation.enter_branch = scope.enter_branch;
+    operation.isBranch = scope.isBranch;
     // Utilize the isExactlyOne function to check operands
     if (opSymbol == "+" && (isExactlyOne(leftOperand) || isExactlyOne(rightOperand))) 
         operation.opType = "INC"; // Increment operation if one operand is exactly "1"
@@ -262,42 +561,41 @@ void NetlistParser::parseOperation(const std::string& operationLine,const std::s
     else if (opSymbol == "?") {
         operation.opType = "MUX2x1";
         operation.operands.push_back(mux_right);
+        operation.operandIds.push_back(mux.id);
     }   
     else if (opSymbol == "") {
         // Find the corresponding component
-        auto resultComponent = std::find_if(components.begin(), components.end(), [&](const Component& comp) { return comp.name == result; });
-
-        // If the result component is found and is registered, assign operation type
-        if (resultComponent != components.end() && !resultComponent->isReg){ 
+        // If the result component is found and is not registered yet, assign operation type
+        if (result.id != SymbolTable::npos && !symbols[result.id].isReg){ 
             operation.opType = "REG";
-            resultComponent->isReg = true;
+            symbols[result.id].isReg = true;
         }    
     }    
     else {
-        std::cerr << "Unsupported operation symbol: " << opSymbol << "\n";
-        std::exit(EXIT_FAILURE); // Terminate the program for unsupported symbols
+        syntaxError(at, "Unsupported operation symbol '" + opSymbol + "'"); // Terminate the program for unsupported symbols
     }
 
     // Here you might want to call determineOperationWidth or assign a width directly
-    operation.width = determineOperationWidth(operation.opType, operation.operands, operation.result);
-    operation.isSigned = determineOperationSign(operation.opType, operation.operands, operation.result);
-    operation.condition = condition; // Assign the current condition context to the operation
-    operation.order = order;
-    operation.prev_order = prev_order;
-    std::string nodeName = operation.opType + " v(" + std::to_string(order)+")"; // Construct a unique node name/id
+    operation.width = determineOperationWidth(operation);
+    operation.isSigned = determineOperationSign(operation);
+    operation.condition = scope.condition.name; // Assign the current condition context to the operation
+    operation.conditionId = scope.condition.id;
+    operation.order = order++;
+    operation.prev_order = prev_order++;
+    std::string nodeName = operation.opType + " v(" + std::to_string(operation.order)+")"; // Construct a unique node name/id
     operation.name = nodeName;
     if (operation.opType == "MUX2x1") 
-        operation.line = result + " <= " + leftOperand + " " + opSymbol + " " + rightOperand +  " " + colon +  " " + mux_right + ";"; 
+        operation.line = result.name + " <= " + leftOperand + " " + opSymbol + " " + rightOperand +  " " + colon +  " " + mux_right + ";"; 
 
     else 
-        operation.line = result + " <= " + leftOperand + " " + opSymbol + " " + rightOperand +  ";"; 
+        operation.line = result.name + " <= " + leftOperand + " " + opSymbol + " " + rightOperand +  ";"; 
     operations.push_back(operation);
 
     #if defined(ENABLE_LOGGING)
     if (opSymbol == "?") 
-        std::cout << "Parsed operation: " << result << " = " << leftOperand << " " << opSymbol << " " << rightOperand <<  " " << colon <<  " " << mux_right << "\t"; 
+        std::cout << "Parsed operation: " << result.name << " = " << leftOperand << " " << opSymbol << " " << rightOperand <<  " " << colon <<  " " << mux_right << "\t"; 
     else 
-        std::cout << "Parsed operation: " << result << " = " << leftOperand << " " << opSymbol << " " << rightOperand << "\t";
+        std::cout << "Parsed operation: " << result.name << " = " << leftOperand << " " << opSymbol << " " << rightOperand << "\t";
     std::cout << " operation.width:"  << operation.width << "\n";
     std::cout << " operation.condition:"  << operation.condition << "\n";
 
@@ -306,280 +604,32 @@ void NetlistParser::parseOperation(const std::string& operationLine,const std::s
 }
 
 
-/*
-int NetlistParser::determineOperationWidth(const std::string& opType, const std::vector<std::string>& operands,const std::string& result) {
-    int maxWidth = 0;
-    if (componentWidths.find(result) != componentWidths.end()) {
-        maxWidth = componentWidths[result];
-    }    
-    for (const auto& operand : operands) {
-        if (isNumeric(operand) || isOnlyWhitespace(operand)) continue; // Skip constants or empty operands
-
-        std::cout << "Operand: " << operand << "\n"; // Debugging print   
-        if (componentWidths.find(operand) != componentWidths.end()) {
-            int width = componentWidths[operand];
-            maxWidth = std::max(maxWidth, width);
-        } else {
-            std::cerr << "Error: Operand/Result " << operand << " not found.\n";
-            std::exit(EXIT_FAILURE); // Exit if an operand width cannot be determined.
-        }
-    }
-    return maxWidth;
-}
-
-*/
-// Function to remove whitespace characters from a string
-void removeWhitespace(std::string &str) {
-    // Use std::remove_if with std::isspace to remove whitespace characters
-    size_t resultPos = str.find_first_not_of(" \t");
-    if (resultPos != std::string::npos) {
-        str.erase(0, resultPos);
+bool NetlistParser::determineOperationSign(const Operation& operation) {
+    // Operation is signed if the result or any operand is declared signed
+    if (operation.resultId != SymbolTable::npos && symbols[operation.resultId].declaredSigned) {
+        return true;
     }
-}
-bool NetlistParser::determineOperationSign(const std::string& opType, const std::vector<std::string>& operands,const std::string& result) {
-     if (componentSignedness.find(result) != componentSignedness.end() && componentSignedness[result]) {
-        return true; // Operation is signed if the result is signed
-    }   
-    for (const auto& operand : operands) {
-        // Check if the operand exists in the componentSignedness map
-        if (isNumeric(operand) || isOnlyWhitespace(operand)) continue; // Skip constants or empty operands
-        if (componentSignedness.find(operand) != componentSignedness.end()) {
-            // If any operand is signed, the operation is considered signed
-            if (componentSignedness[operand]) {
-                return true;
-            }
-        } else {
-            std::cerr << "Error: Operand/Result " << operand << " not found.\n";
-            std::exit(EXIT_FAILURE); // Exit if an operand's signedness cannot be determined.
+    for (int id : operation.operandIds) {
+        if (id != SymbolTable::npos && symbols[id].declaredSigned) {
+            return true;
         }
     }
     // Return false if none of the operands are signed
     return false;
 }
-int order = 0;
-int prev_order = -1;
-std::stack<std::string> conditionStack;
-bool nextIsElse = false;
-bool enter_branch = false;
-bool isBranch = false;
-std::string extractedCondition;
-std::string getSecondTop(std::stack<std::string>& stack) {
-    if (stack.size() < 2) {
-        // Less than two elements means there is no second top element
-        return "";
-    }
-
-    std::string top = stack.top(); // Temporarily hold the top element
-    stack.pop();                   // Remove the top element
-    std::string secondTop = stack.top(); // Now the top is the second top
-    stack.push(top);               // Restore the original top element
-
-    return secondTop;
+const std::vector<Component>& NetlistParser::getComponents() const {
+    return symbols.entries();
 }
-void NetlistParser::parseLine(const std::string& line) {
-    size_t commentPos = line.find("//");
-
-    //std::istringstream stream(line);
-    // Extract the part of the line before the comment (if any)
-    std::string cleanedLine = (commentPos != std::string::npos) ? line.substr(0, commentPos) : line;
-
-    // Continue parsing only if there's something left after removing the comment
-    if (!cleanedLine.empty()) {
-        std::istringstream stream(cleanedLine);
-        std::string word;
-        stream >> word;   
-
-        if (word == "input" || word == "output" || word == "wire" || word == "variable") {
-            std::string dataType;
-            stream >> dataType;
-            // Check data type validity
-            if (!(dataType.substr(0, 3) == "Int" && dataType.length() > 3 && isdigit(dataType[3])) &&
-                !(dataType.substr(0, 4) == "UInt" && dataType.length() > 4 && isdigit(dataType[4]))) {
-                std::cerr << "Error: Data type must be 'Int' or 'UInt', found '" << dataType << "' in line: " << line << "\n";
-                std::exit(EXIT_FAILURE);
-            }      
-            int width = std::stoi(dataType.substr(dataType.find_first_of("1234567890")));
-        
-            bool isSigned = dataType.substr(0, 3) == "Int";
-
-            std::string restOfLine;
-            getline(stream, restOfLine, '\n'); // Get the rest of the line after dataType
-            std::istringstream restStream(restOfLine);
-            std::string componentName;
-
-            while (getline(restStream, componentName, ',')) {
-                // Remove spaces from componentName
-                componentName.erase(remove_if(componentName.begin(), componentName.end(), isspace), componentName.end());
-
-                if (!componentName.empty()) {
-                    Component component;
-                    component.type = word;
-                    if(component.type == "variable") component.isReg = true;
-                    component.name = componentName;
-                    component.width = width;
-                    if(width == 1) component.isSigned = false;
-                    else component.isSigned = isSigned;
-                    components.push_back(component);
-                    componentWidths[componentName] = width; // Update componentWidths map
-                    componentSignedness[componentName] = isSigned; // Track signedness of components
-                    #if defined(ENABLE_LOGGING)
-                    std::cout << "Parsed " << word << ": " << componentName << " with width " << width << (component.isSigned ? ", signed" : ", unsigned") << "\n"; 
-                    #endif
-                }
-            }
-  
-        } else {
-            // Handling operation lines
-#if defined(ENABLE_LOGGING)
-            std::cout << cleanedLine << std::endl;
-#endif
-            removeWhitespace(cleanedLine); 
-            /*if (cleanedLine.find("if") != std::string::npos) {
-                // Correctly extract the condition when entering an 'if' block
-                currentCondition = cleanedLine.substr(cleanedLine.find("(") + 1, cleanedLine.find(")") - cleanedLine.find("(") - 1);
-                //currentCondition = "g";
-                trim(currentCondition);
-                // Print the current condition for debugging
-                std::cout << "Entering IF block, condition: " << currentCondition << std::endl;
-                parseBranch("IF",currentCondition,order++,prev_order++);  
-
-            }
-            else if (cleanedLine.find("}") != std::string::npos) {
-                // Correctly clear the condition after exiting an 'if' block
-                std::cout << "Exiting IF block, clearing condition: " << currentCondition << std::endl;
-                currentCondition.clear();
-            }
-            else{  
-              size_t eqPos = cleanedLine.find('=');
-              if (eqPos != std::string::npos) {
-                parseOperation(cleanedLine,currentCondition,order++,prev_order++);  
-
-              }
-            }*/
-            /*if (cleanedLine.find("if") != std::string::npos) {
-                // Extract the condition from within the parentheses of the 'if'
-                size_t start = cleanedLine.find("(") + 1;
-                size_t end = cleanedLine.find(")");
-                currentCondition = cleanedLine.substr(start, end - start);
-                trim(currentCondition);  // Assume trim is a function that removes whitespace
-
-                // Debugging output
-                std::cout << "Entering IF block, condition: " << currentCondition << std::endl;
-
-                // Parse the branching operation for entering the 'if'
-            
-                parseBranch("IF", currentCondition,"", order++, prev_order++);
-            }
-            else if (cleanedLine.find("}") != std::string::npos) {
-                // When exiting the 'if' block
-                std::cout << "Exiting IF block, clearing condition: " << currentCondition << std::endl;
-                currentCondition.clear();
-            }
-            else {
-                // Handle normal operations inside or outside of 'if' blocks
-                size_t eqPos = cleanedLine.find('=');
-                if (eqPos != std::string::npos) {
-                    parseOperation(cleanedLine, currentCondition, order++, prev_order++);
-                }
-            }*/
-            /*
-            if (cleanedLine.find("if") != std::string::npos) {
-                // Extract the condition from within the parentheses of the 'if'
-                size_t start = cleanedLine.find("(") + 1;
-                size_t end = cleanedLine.find(")");
-                std::string extractedCondition = cleanedLine.substr(start, end - start);
-                trim(extractedCondition);  // Assume trim is a function that removes whitespace
-
-                // Debugging output
-                std::cout << "Entering IF block, condition: " << extractedCondition << std::endl;
-
-                // Keep track of the current condition before pushing a new one
-                std::string prevCondition;
-                if (!conditionStack.empty()) {
-                    prevCondition = conditionStack.top();
-                }
-
-                // Push the new condition onto the stack
-                conditionStack.push(extractedCondition);
-
-                // Parse the branching operation for entering the 'if'
-                parseBranch("IF", extractedCondition, prevCondition, order++, prev_order++);
-            }
-            else if (cleanedLine.find("}") != std::string::npos) {
-                // When exiting the 'if' block, ensure there's a condition to pop
-                if (!conditionStack.empty()) {
-                    std::cout << "Exiting IF block, clearing condition: " << conditionStack.top() << std::endl;
-                    conditionStack.pop();
-                }
-
-                // Restore previous condition if there is one
-                std::string restoredCondition = conditionStack.empty() ? "" : conditionStack.top();
-                std::cout << "Condition restored to: " << restoredCondition << std::endl;
-            }
-            else {
-                // Handle normal operations inside or outside of 'if' blocks
-                size_t eqPos = cleanedLine.find('=');
-                if (eqPos != std::string::npos) {
-                    std::string currentCondition = conditionStack.empty() ? "" : conditionStack.top();
-                    parseOperation(cleanedLine, currentCondition, order++, prev_order++);
-                }
-            }                        
-            */
-            if (cleanedLine.find("if") != std::string::npos) {
-                size_t start = cleanedLine.find("(") + 1;
-                size_t end = cleanedLine.find(")");
-                extractedCondition = cleanedLine.substr(start, end - start);
-                trim(extractedCondition);
-
-                // Push the new condition onto the stack
-                conditionStack.push(extractedCondition);
-                enter_branch = true;
-                isBranch = true;
-                // Parse the branching operation for entering the 'if'
-                parseBranch("IF", extractedCondition, getSecondTop(conditionStack), enter_branch, order++, prev_order++);
-                #if defined(ENABLE_LOGGING)  
-                std::cout << "Entering IF block, condition: " << extractedCondition << std::endl;
-                #endif 
-            }
-            else if (cleanedLine.find("else") != std::string::npos) {
-                enter_branch = false;
-                isBranch = true;
-                conditionStack.push(extractedCondition);  // Duplicate the last 'if' condition for the 'else' block
-                #if defined(ENABLE_LOGGING)  
-                std::cout << "Entering ELSE block, using condition of last IF: " << extractedCondition << std::endl;
-                #endif 
-            }
-            else if (cleanedLine.find("}") != std::string::npos) {
-                // Reset enter_branch only if exiting a conditional block that was directly active
-                if (!conditionStack.empty()) {
-                        conditionStack.pop(); // Correctly pop the stack when exiting the conditional block
-                }
-                #if defined(ENABLE_LOGGING)  
-                std::cout << "Exiting block, condition stack size now: " << conditionStack.size() << std::endl;
-                #endif 
-            }
-            else {
-                size_t eqPos = cleanedLine.find('=');
-                if (eqPos != std::string::npos) {
-                    std::string currentCondition = conditionStack.empty() ? "" : conditionStack.top();
-                    isBranch = conditionStack.empty() ? false :true;
-                    enter_branch = conditionStack.empty() ? false :enter_branch;
-                    parseOperation(cleanedLine, currentCondition, enter_branch,isBranch, order++, prev_order++);
-                }
-            }
-            
 
-        }
-    }    
+std::vector<Operation>& NetlistParser::getOperations()  {
+    return operations;
 }
 
 
-
-const std::vector<Component>& NetlistParser::getComponents() const {
-    return components;
+const SymbolTable& NetlistParser::getSymbols() const {
+    return symbols;
 }
 
-std::vector<Operation>& NetlistParser::getOperations()  {
-    return operations;
+const std::vector<std::string>& NetlistParser::getWarnings() const {
+    return warnings;
 }
-
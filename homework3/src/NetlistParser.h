@@ -15,6 +15,10 @@
 #include <locale>
 #include <map>
 #include <set>
+#include <string_view>
+
+#include "NetlistLexer.h"
+#include "SymbolTable.h"
 
 // Define the map as a static member of the class (or globally if more appropriate for your design)
 static std::unordered_map<std::string, std::string> operationSymbols = {
@@ -28,16 +32,6 @@ static std::unordered_map<std::string, std::string> operationSymbols = {
 
     // Add more symbols and their corresponding operation types as needed
 };
-// Represents a generic component in the netlist (e.g., input, output, wire)
-struct Component {
-    std::string type;
-    std::string name;
-    int width;
-    bool isSigned;
-    bool isReg = false;
-    bool isNew = false;
-};
-
 // Represents an operation in the netlist (e.g., ADD, SUB, MUL)
 struct Operation {
     std::string opType;
@@ -57,8 +51,11 @@ struct Operation {
     std::string fds_type;
     int cycles=0;
     std::string resource;
-    std::vector<std::string> predecessors;
-    std::vector<std::string> successors;
+    int id = -1; // Node id in the OperationGraph, -1 if the operation has none
+    // Symbol ids of result, operands and condition (SymbolTable::npos for constants and empty ones)
+    int resultId = SymbolTable::npos;
+    std::vector<int> operandIds;
+    int conditionId = SymbolTable::npos;
     // Function to print operation details
    void printDetails() const {
         std::cout << "Operation Name: " << name << "\t"
@@ -79,53 +76,99 @@ struct Operation {
                   << "enter_branch: " << enter_branch << "\t"
                   << "Type: " << opType << "\t"
                   << "Resource: " << resource << "\t"
-                  << "Cycles: " << cycles << "\t\n"
-                  << "Predecessors: ";
+                  << "Cycles: " << cycles << "\t" << std::endl;
+    }       
+};
 
-        for (const auto& pred : predecessors) {
-            std::cout << pred << " ";
-        }
+// A resolved operand: its text and symbol id (SymbolTable::npos for constants and empty operands)
+struct Operand {
+    std::string name;
+    int id = SymbolTable::npos;
+};
 
-        std::cout << "\tSuccessors: ";
-        for (const auto& succ : successors) {
-            std::cout << succ << " ";
-        }
-        std::cout << std::endl;
-    }       
+// Branch context of the statements being parsed
+struct BranchScope {
+    Operand condition;          // condition of the innermost if, empty at top level
+    bool enter_branch = false;  // true in the if body, false in the else body
+    bool isBranch = false;      // inside any if/else body
+};
+
+// Node of the expression tree of one statement. Leaves hold an operand token, inner nodes
+// the operator token and the indices of their children in the parser's expression arena.
+struct ExpressionNode {
+    const Token* token;
+    int left = -1;
+    int right = -1;
+    int otherwise = -1;  // false value of a '?' node
 };
 
 class NetlistParser {
 public:
     NetlistParser(const std::string& filePath);
     void parse();
+    // Parses netlist text held in memory; filePath is not read
+    void parseSource(std::string_view source);
     const std::vector<Component>& getComponents() const;
     std::vector<Operation>& getOperations() ;
-    std::unordered_map<std::string, int> componentWidths;
-    std::unordered_map<std::string, bool> componentSignedness;
+    const SymbolTable& getSymbols() const;
+    // Problems the parser worked around, e.g. an output that is also read; the caller decides where they go
+    const std::vector<std::string>& getWarnings() const;
     void parseIfOperations(const std::string& ifStatement, const std::string& condition);
     void modifyModuleName(std::string& moduleName);
 private:
     std::string filePath;
-    std::vector<Component> components;
+    SymbolTable symbols;
     std::vector<Operation> operations;
-    void parseLine(const std::string& line);
-    int determineOperationWidth(const std::string& opType, const std::vector<std::string>& operands, const std::string& result); // Ensure this line is in your NetlistParser class
-    bool determineOperationSign(const std::string& opType, const std::vector<std::string>& operands, const std::string& result);
-    void parseOperation(const std::string& operationLine,const std::string& condition, bool enter_branch, bool isBranch, int state, int prev_state);
-    void parseBranch(const std::string& branch_type,const std::string& self_condition, const std::string& prev_condition, bool enter_branch,int order, int prev_order); 
-    // Existing private members...
-    std::string currentCondition; // Track the current conditional context for operations
+    std::vector<std::string> warnings;
+    int determineOperationWidth(const Operation& operation);
+    bool determineOperationSign(const Operation& operation);
+
+    // Recursive-descent parser over the token stream of the whole file
+    std::vector<Token> tokens;
+    std::vector<std::string_view> lines;      // source line of each line number, for diagnostics
+    size_t cursor = 0;
+    std::vector<ExpressionNode> expression;   // arena of the statement being parsed
+    int order = 0;
+    int prev_order = -1;
+    int temporaries = 0;
+
+    const Token& peek() const;
+    bool atEnd() const;
+    bool accept(std::string_view text);
+    const Token& expect(std::string_view text);
+    [[noreturn]] void syntaxError(const Token& at, const std::string& message) const;
+    Operand resolveOperand(const Token& operand) const;
+    void releaseSource();
+
+    void parseStatement(const BranchScope& scope);
+    void parseDeclaration();
+    void parseIf(const BranchScope& scope);
+    void parseBlock(const BranchScope& scope);
+    void parseAssignment(const BranchScope& scope);
+    int parseExpression();
+    int parseBinary(int level);
+    int parsePrimary();
+
+    // Lowering of expression trees into Operation records, with temporaries for inner nodes
+    int expressionWidth(int index) const;
+    bool expressionSigned(int index) const;
+    void lowerAssignment(const Operand& result, int index, int width, const BranchScope& scope);
+    // isSigned also makes the temporary signed, for the operands of a signed comparison
+    Operand lowerOperand(int index, int width, const BranchScope& scope, bool isSigned = false);
+    Operand declareTemporary(int width, bool isSigned);
+    void parseBranch(const std::string& branch_type, const Operand& self_condition, const BranchScope& scope);
+    void lowerOperation(const Operand& result, const std::string& opSymbol, const Operand& left, const Operand& right, const Operand& mux, const Token& at, const BranchScope& scope);
 };
 
 
 
-inline bool isNumeric(const std::string& str) {
+inline bool isNumeric(std::string_view str) {
     return !str.empty() && std::all_of(str.begin(), str.end(), [](unsigned char c) { return std::isdigit(c); });
 }
-inline bool isExactlyOne(const std::string& str) {
+inline bool isExactlyOne(std::string_view str) {
     return str == "1";
 }
-inline bool isOnlyWhitespace(const std::string& str) {
+inline bool isOnlyWhitespace(std::string_view str) {
     return std::all_of(str.begin(), str.end(), [](unsigned char c) { return std::isspace(c); });
 }
 
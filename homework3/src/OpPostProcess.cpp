@@ -1,17 +1,172 @@
 #include "OpPostProcess.h"
+#include "resource_library.h"
 #include <iostream>
 #include <fstream>
 #include <unordered_set>
 #include <queue>
+#include <algorithm>
 
 void printGraphDetails(const OperationGraph& graph) {
-    for (const auto& pair : graph.nodes) {
-        pair.second.printDetails();
-    }
+    graph.printDetails();
 }
 
 
-OperationGraph OpPostProcess(const std::string& moduleName, NetlistParser& parser) {
+namespace {
+
+// Operations that may have written a symbol last, and those that read it since
+struct Definitions {
+    std::vector<size_t> writers;
+    std::vector<size_t> readers;
+};
+
+// Definitions of every symbol while the operations are visited in program order. An open if or
+// else arm only records what it changed; when the if ends both arms are merged into the
+// enclosing scope, where a symbol written in one arm may still hold its value from before the if.
+class DefinitionScopes {
+public:
+    explicit DefinitionScopes(size_t symbols) : global(symbols) {}
+
+    // Moves into the given arms (IF and side, outermost first), merging the arms that end
+    void enter(const std::vector<std::pair<size_t, bool>>& path) {
+        size_t common = 0;
+        while (common < arms.size() && common < path.size() && arms[common].test == path[common].first &&
+               arms[common].enter_branch == path[common].second) {
+            common++;
+        }
+        while (arms.size() > common + 1) {
+            close();
+        }
+        if (arms.size() > common) {
+            if (common < path.size() && arms.back().test == path[common].first) {
+                // The else arm starts from the definitions before the if
+                Arm& arm = arms.back();
+                arm.otherArm = std::move(arm.changes);
+                arm.changes.clear();
+                arm.enter_branch = path[common].second;
+                common++;
+            } else {
+                close();
+            }
+        }
+        for (; common < path.size(); common++) {
+            arms.push_back({path[common].first, path[common].second, {}, {}});
+        }
+    }
+
+    const std::vector<size_t>& writers(int symbol) const {
+        for (auto arm = arms.rbegin(); arm != arms.rend(); ++arm) {
+            auto change = arm->changes.find(symbol);
+            if (change != arm->changes.end() && change->second.wrote) {
+                return change->second.definitions.writers;
+            }
+        }
+        return global[symbol].writers;
+    }
+
+    std::vector<size_t> readers(int symbol) const {
+        std::vector<size_t> result;
+        for (auto arm = arms.rbegin(); arm != arms.rend(); ++arm) {
+            auto change = arm->changes.find(symbol);
+            if (change != arm->changes.end()) {
+                const std::vector<size_t>& added = change->second.definitions.readers;
+                result.insert(result.end(), added.begin(), added.end());
+                if (change->second.wrote) {
+                    return result;
+                }
+            }
+        }
+        result.insert(result.end(), global[symbol].readers.begin(), global[symbol].readers.end());
+        return result;
+    }
+
+    void read(int symbol, size_t index) {
+        if (arms.empty()) {
+            global[symbol].readers.push_back(index);
+        } else {
+            arms.back().changes[symbol].definitions.readers.push_back(index);
+        }
+    }
+
+    void write(int symbol, size_t index) {
+        define(symbol, {{index}, {}});
+    }
+
+private:
+    struct Change {
+        bool wrote = false;       // definitions replaced in this arm, otherwise only the readers it added
+        Definitions definitions;
+    };
+    struct Arm {
+        size_t test;
+        bool enter_branch;
+        std::unordered_map<int, Change> changes;
+        std::unordered_map<int, Change> otherArm;  // changes of the if arm once the else arm is open
+    };
+
+    std::vector<Definitions> global;
+    std::vector<Arm> arms;
+
+    void define(int symbol, Definitions definitions) {
+        if (arms.empty()) {
+            global[symbol] = std::move(definitions);
+        } else {
+            arms.back().changes[symbol] = {true, std::move(definitions)};
+        }
+    }
+
+    void close() {
+        Arm arm = std::move(arms.back());
+        arms.pop_back();
+        std::vector<int> changed;
+        for (const auto& change : arm.changes) {
+            changed.push_back(change.first);
+        }
+        for (const auto& change : arm.otherArm) {
+            if (arm.changes.find(change.first) == arm.changes.end()) {
+                changed.push_back(change.first);
+            }
+        }
+        for (int symbol : changed) {
+            auto first = arm.changes.find(symbol);
+            auto second = arm.otherArm.find(symbol);
+            const Change* sides[2] = {first == arm.changes.end() ? nullptr : &first->second,
+                                      second == arm.otherArm.end() ? nullptr : &second->second};
+            if ((sides[0] == nullptr || !sides[0]->wrote) && (sides[1] == nullptr || !sides[1]->wrote)) {
+                for (const Change* side : sides) {
+                    if (side == nullptr) {
+                        continue;
+                    }
+                    for (size_t reader : side->definitions.readers) {
+                        read(symbol, reader);
+                    }
+                }
+                continue;
+            }
+            // Either arm may have run, and one that did not write keeps the definitions before the if
+            Definitions merged;
+            for (const Change* side : sides) {
+                const std::vector<size_t>& sideWriters = side != nullptr && side->wrote ? side->definitions.writers : writers(symbol);
+                merged.writers.insert(merged.writers.end(), sideWriters.begin(), sideWriters.end());
+                if (side == nullptr || !side->wrote) {
+                    std::vector<size_t> before = readers(symbol);
+                    merged.readers.insert(merged.readers.end(), before.begin(), before.end());
+                }
+                if (side != nullptr) {
+                    merged.readers.insert(merged.readers.end(), side->definitions.readers.begin(), side->definitions.readers.end());
+                }
+            }
+            for (std::vector<size_t>* list : {&merged.writers, &merged.readers}) {
+                std::sort(list->begin(), list->end());
+                list->erase(std::unique(list->begin(), list->end()), list->end());
+            }
+            define(symbol, std::move(merged));
+        }
+    }
+};
+
+}
+
+OperationGraph OpPostProcess([[maybe_unused]] const std::string& moduleName, NetlistParser& parser) {
     OperationGraph opGraph;
     Operation sourceOp;
     sourceOp.name = "source";
@@ -25,33 +180,25 @@ OperationGraph OpPostProcess(const std::string& moduleName, NetlistParser& parse
     sinkOp.resource = "None";
     sinkOp.cycles = 0;
 
-    opGraph.addNode(sourceOp.name, sourceOp);
-    opGraph.addNode(sinkOp.name, sinkOp);
     // Get the operations from the parser
     std::vector<Operation>& operations = parser.getOperations();
     // Add source and sink operations to the vector
     operations.insert(operations.begin(), sourceOp); // Insert source at the beginning
     operations.push_back(sinkOp);                   // Add sink to the end
-    // Traverse operations and add nodes to the graph
-    for (auto& op : operations) {
-        if(op.opType == "MUL"){
-            op.resource = "multiplier";
-            op.cycles = 2;
-        }
-        else if (op.opType == "ADD" || op.opType == "SUB" ||  op.opType == "INC" ||  op.opType == "DEC"){
-            op.resource = "adder/subtractor";
-            op.cycles = 1;                
-        }
-        else if (op.opType == "DIV" || op.opType == "MOD" ){
-            op.resource = "divider/modulo";
-            op.cycles = 3;                
-        }
-        else if (op.opType == "COMP" || op.opType == "MUX2x1" || op.opType == "SHL" || op.opType == "SHR" || op.opType == "IF"){
-            op.resource = "logic/logical";
-            op.cycles = 1;                
+    // Traverse operations and add nodes to the graph; graphIds maps an operation's
+    // position in the parser to its node id (-1 for registers, which get no node)
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+    const ResourceLibrary& library = ResourceLibrary::instance();
+    std::vector<int> graphIds(operations.size(), -1);
+    for (size_t index = 0; index < operations.size(); index++) {
+        Operation& op = operations[index];
+        int resource_id = registry.id_of_op_type(op.opType);
+        if (resource_id >= 0) {
+            op.resource = registry.at(resource_id).resource;
+            op.cycles = library.cycles(op.opType, op.width);
         }
         if (op.opType != "REG") {
-            opGraph.addNode(op.name,op); // Use operation name as node name
+            graphIds[index] = opGraph.addNode(op);
         }
 
 
@@ -74,48 +221,74 @@ OperationGraph OpPostProcess(const std::string& moduleName, NetlistParser& parse
         }
     }
     */
-    // Updated loop to construct the graph without adding redundant edges
+    // Branch structure: a branch body follows its IF, so the last IF testing a condition is the
+    // one guarding an operation on it
+    const SymbolTable& symbols = parser.getSymbols();
+    std::vector<int> guards(operations.size(), -1);
+    std::vector<int> lastTest(symbols.size(), -1);
+    for (size_t index = 0; index < operations.size(); index++) {
+        const Operation& op = operations[index];
+        if (op.conditionId != SymbolTable::npos) {
+            guards[index] = lastTest[op.conditionId];
+        }
+        if (op.opType == "IF" && op.resultId != SymbolTable::npos) {
+            lastTest[op.resultId] = index;
+        }
+    }
 
-  
-    for (const auto& op : operations) {
-        for (const auto& operand : op.operands) {
-            for (const auto& otherOp : operations) {
-                bool only_comp_cond = otherOp.result == operand && otherOp.opType!="IF" ; //&& (otherOp.enter_branch == op.enter_branch || (!otherOp.isBranch && !op.isBranch)) 
-                bool nested_if_cond = (otherOp.result == op.condition) && op.condition !="" && otherOp.opType == "IF";
-                bool if_output = (otherOp.result == op.condition) && op.condition !="" && otherOp.opType == "IF";
-                bool if_input = (otherOp.result == operand) && op.opType == "IF";
-                bool only_comp_cond_general = only_comp_cond && ((otherOp.enter_branch == op.enter_branch) || otherOp.isBranch != op.isBranch );
-                if ( only_comp_cond_general  || if_output || if_input)  {
-                    // Before adding an edge, check if 'otherOp' is already reachable from 'op'
-                    // This prevents adding redundant edges
-                    if (!opGraph.isReachable(otherOp.name, op.name)) {
-                        opGraph.addEdge(otherOp.name, op.name, otherOp.result); // Add edge if not redundant
-                    }
-                }
-                
+    // Connect every operation, in program order, to the writers its operands and conditions may
+    // read, and every write to the earlier writes and reads of its result, so no schedule can
+    // reorder them; an operation in a branch also follows the IF guarding it
+    DefinitionScopes scopes(symbols.size());
+    std::vector<std::pair<size_t, bool>> arms;
+    std::vector<int> reads;
+    for (size_t index = 0; index < operations.size(); index++) {
+        const Operation& op = operations[index];
+        if (graphIds[index] < 0) {
+            continue;
+        }
+        arms.clear();
+        reads.clear();
+        for (int operand : op.operandIds) {
+            if (operand != SymbolTable::npos && std::find(reads.begin(), reads.end(), operand) == reads.end()) {
+                reads.push_back(operand);
             }
         }
-    }   
-    for (auto& [nodeName, node] : opGraph.nodes) {
-        if (nodeName != "source" && nodeName != "sink") {
-            // Connect to 'source' only if there are no predecessors
-            //std::cout << "current node is: " << node.name << std::endl;
-            if (node.predecessors.empty()) {
-                //opGraph.addEdge("source", nodeName, "");
-                opGraph.nodes["source"].successors.push_back(nodeName);
-                node.predecessors.push_back("source");
-                
+        bool enter_branch = op.enter_branch;
+        for (int guard = guards[index]; guard >= 0; guard = guards[guard]) {
+            arms.insert(arms.begin(), {guard, enter_branch});
+            enter_branch = operations[guard].enter_branch;
+            int condition = operations[guard].resultId;
+            if (std::find(reads.begin(), reads.end(), condition) == reads.end()) {
+                reads.push_back(condition);
             }
+        }
+        scopes.enter(arms);
 
-            // Connect to 'sink' only if there are no successors
-            if (node.successors.empty()) {
-                //opGraph.addEdge(nodeName, "sink", "");
-                opGraph.nodes["sink"].predecessors.push_back(nodeName);
-                node.successors.push_back("sink");
-                
+        if (guards[index] >= 0) {
+            opGraph.addEdge(graphIds[guards[index]], graphIds[index], operations[guards[index]].result);
+        }
+        for (int symbol : reads) {
+            for (size_t writer : scopes.writers(symbol)) {
+                opGraph.addEdge(graphIds[writer], graphIds[index], symbols[symbol].name);
+            }
+        }
+        for (int symbol : reads) {
+            scopes.read(symbol, index);
+        }
+        if (op.opType != "IF" && op.resultId != SymbolTable::npos) {
+            for (size_t writer : scopes.writers(op.resultId)) {
+                opGraph.addEdge(graphIds[writer], graphIds[index], op.result);
+            }
+            for (size_t reader : scopes.readers(op.resultId)) {
+                opGraph.addEdge(graphIds[reader], graphIds[index], op.result);
             }
+            scopes.write(op.resultId, index);
         }
     }
+    // Redundant edges are dropped, then operations without predecessors hang off 'source'
+    // and those without successors feed 'sink'
+    opGraph.finalize();
     
 #if defined(ENABLE_LOGGING)  
 
@@ -131,18 +304,18 @@ OperationGraph OpPostProcess(const std::string& moduleName, NetlistParser& parse
     file << "digraph OperationGraph {\n";
 
     // Declare nodes
-    for (const auto& node : opGraph.nodes) {
-        file << "  \"" << node.first << "\";\n";
+    for (const auto& node : opGraph.operations) {
+        file << "  \"" << node.name << "\";\n";
     }
 
     // Declare edges with conditions
     for (const auto& edge : opGraph.edges) {
-        for (const auto& [target, condition] : edge.second) {
-            if (!condition.empty()) {
-                file << "  \"" << edge.first << "\" -> \"" << target << "\" [label=\"" << condition << "\"];\n";
-            } else {
-                file << "  \"" << edge.first << "\" -> \"" << target << "\";\n";
-            }
+        const std::string& from = opGraph.operations[edge.from].name;
+        const std::string& target = opGraph.operations[edge.to].name;
+        if (!edge.condition.empty()) {
+            file << "  \"" << from << "\" -> \"" << target << "\" [label=\"" << edge.condition << "\"];\n";
+        } else {
+            file << "  \"" << from << "\" -> \"" << target << "\";\n";
         }
     }
 
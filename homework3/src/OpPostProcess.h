@@ -1,6 +1,7 @@
 #ifndef OPPOSTPROCESS_H
 #define OPPOSTPROCESS_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -8,6 +9,8 @@
 #include <iostream>
 #include <fstream>
 #include "NetlistParser.h"
+#include "resources.h"
+#include "dependency_graph.h"
 #include <stack> // For std::stack
 /*struct NodeDetails {
     std::vector<std::string> predecessors;
@@ -27,119 +30,109 @@
 
 
 
+// Data/branch dependency between two operations, labelled with the variable or condition it carries
+struct OperationEdge {
+    int from;
+    int to;
+    std::string condition;
+};
+
 // Define OperationGraph directly in OpPostProcess.h
 class OperationGraph {
 public:
-    std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> edges;
-    //std::unordered_set<std::string> nodes;
-    //std::unordered_map<std::string, NodeDetails> nodes;  // Changed from std::unordered_set<std::string>
-    std::unordered_map<std::string, Operation> nodes;  // Stores Operation structs including predecessor and successor info
-
-    /*void addEdge(const std::string& from, const std::string& to, const std::string& condition) {
-        edges[from].push_back({to, condition});
-    }*/
-    void addEdge(const std::string& from, const std::string& to, const std::string& condition) {
-        if (!isReachable(from, to)) {
-            edges[from].push_back({to, condition});
-            nodes[from].successors.push_back(to);
-            nodes[to].predecessors.push_back(from);
+    // Operations indexed by Operation::id; source is the first entry and sink the last one
+    std::vector<Operation> operations;
+    // Dependencies between operations in insertion order (without the source/sink links);
+    // after finalize() only the edges of the transitive reduction remain
+    std::vector<OperationEdge> edges;
+    // Fan-in/fan-out of every operation including the source/sink links, built by finalize()
+    DependencyGraph dependencies;
+
+    // Stores the operation under the next dense id and returns that id
+    int addNode(const Operation& op) {
+        int id = operations.size();
+        operations.push_back(op);
+        operations.back().id = id;
+        return id;
+    }
 
-            // Print the connection that is being added
-            /*std::cout << "Added edge from " << from << " to " << to << " with condition: " << condition << std::endl;
-            std::cout << " - " << from << " next nodes: ";
-            for (const auto& succ : nodes[from].successors) std::cout << succ << " ";
-            std::cout << std::endl;
-            std::cout << " - " << to << " previous nodes: ";
-            for (const auto& pred : nodes[to].predecessors) std::cout << pred << " ";
-            std::cout << std::endl;*/
+    void addEdge(int from, int to, const std::string& condition) {
+        // Self loops (x = x + 1) and repeated edges carry no extra ordering
+        if (from == to || !edgeKeys.insert((uint64_t(from) << 32) | uint32_t(to)).second) {
+            return;
         }
-    }    
-    std::vector<Operation> sortOperations(const std::unordered_map<std::string, Operation>& nodes) {
-        std::vector<Operation> sortedOperations;
+        edges.push_back({from, to, condition});
+    }
 
-        // Ensure source and sink are present
-        if (nodes.find("source") == nodes.end() || nodes.find("sink") == nodes.end()) {
-            throw std::runtime_error("Source or sink node missing");
+    // Drops the edges implied by longer paths, then links the graph
+    void finalize() {
+        std::vector<std::pair<int, int>> links;
+        links.reserve(edges.size());
+        for (const auto& edge : edges) {
+            links.push_back({edge.from, edge.to});
         }
 
-        // Reserve space for efficiency, excluding source and sink
-        sortedOperations.reserve(nodes.size() - 2);
-
-        // Add all operations except source and sink
-        for (const auto& pair : nodes) {
-            if (pair.first != "source" && pair.first != "sink") {
-                sortedOperations.push_back(pair.second);
+        std::vector<bool> transitive = find_transitive_edges(operations.size(), links);
+        std::vector<OperationEdge> kept;
+        kept.reserve(edges.size());
+        for (size_t index = 0; index < edges.size(); index++) {
+            if (!transitive[index]) {
+                kept.push_back(edges[index]);
             }
         }
-
-        // Sort operations by 'order'
-        std::sort(sortedOperations.begin(), sortedOperations.end(), [](const Operation& a, const Operation& b) {
-            return a.order < b.order;
-        });
-
-        // Insert 'source' at the beginning and 'sink' at the end
-        sortedOperations.insert(sortedOperations.begin(), nodes.at("source"));
-        sortedOperations.push_back(nodes.at("sink"));
-
-        return sortedOperations;
+        edges.swap(kept);
+        edgeKeys.clear();
+        link();
     }
 
-    /*void addNode(const std::string& nodeName) {
-        nodes.insert(nodeName);
-    }*/
-    /*void addNode(const std::string& nodeName) {
-        if (nodes.find(nodeName) == nodes.end()) {
-            nodes[nodeName] = NodeDetails();  // Initialize with empty NodeDetails
+    // Connects operations without predecessors to source and those without successors to sink,
+    // then freezes the dependencies into the CSR representation
+    void link() {
+        int sourceId = 0;
+        int sinkId = operations.size() - 1;
+        std::vector<std::pair<int, int>> links;
+        links.reserve(edges.size() + 2 * operations.size());
+        std::vector<char> hasPredecessor(operations.size(), 0);
+        std::vector<char> hasSuccessor(operations.size(), 0);
+        for (const auto& edge : edges) {
+            links.push_back({edge.from, edge.to});
+            hasSuccessor[edge.from] = 1;
+            hasPredecessor[edge.to] = 1;
         }
-    }*/
-    // This method should accept an Operation object, not just the name
-    void addNode(const std::string& nodeName, const Operation& op) {
-        nodes[nodeName] = op; // Directly store the passed Operation object
-    }
-
-    void printConnectionsInOrder();
-
-    void generateGraphviz(const std::string& filename);
-    bool isReachable(const std::string& from, const std::string& to) {
-        if (from == to) return true; // Early return if the nodes are the same
 
-        std::unordered_set<std::string> visited;
-        std::stack<std::string> stack;
-        stack.push(from);
-
-        while (!stack.empty()) {
-            std::string current = stack.top();
-            stack.pop();
-
-            if (visited.find(current) != visited.end()) {
-                continue;
+        for (int id = sourceId + 1; id < sinkId; id++) {
+            if (!hasPredecessor[id]) {
+                links.push_back({sourceId, id});
             }
-            visited.insert(current);
-
-            auto it = edges.find(current);
-            if (it == edges.end()) {
-                continue;
-            }
-
-            for (const auto& edge : it->second) {
-                if (edge.first == to) {
-                    return true;
-                }
-                stack.push(edge.first);
+            if (!hasSuccessor[id]) {
+                links.push_back({id, sinkId});
             }
         }
-
-        return false;
+        dependencies = DependencyGraph(operations.size(), links);
     }
-private:
-    void findAllReachable(const std::string& start, std::unordered_set<std::string>& visited) {
-        for (const auto& edge : edges[start]) {
-            if (visited.insert(edge.first).second) { // Successfully inserted (not yet visited)
-                findAllReachable(edge.first, visited);
+
+    const Operation& source() const { return operations.front(); }
+    const Operation& sink() const { return operations.back(); }
+
+    // Operations (including source and sink) with their predecessors and successors
+    void printDetails() const {
+        for (const auto& op : operations) {
+            op.printDetails();
+            std::cout << "Predecessors: ";
+            for (int pred : dependencies.predecessors(op.id)) {
+                std::cout << operations[pred].name << " ";
+            }
+            std::cout << "\tSuccessors: ";
+            for (int succ : dependencies.successors(op.id)) {
+                std::cout << operations[succ].name << " ";
             }
+            std::cout << std::endl;
         }
-    }  
+    }
 
+private:
+    // (from, to) pairs already added, used while edges are still being added
+    std::unordered_set<uint64_t> edgeKeys;
 };
 
 // Declaration of OpPostProcess function
@@ -0,0 +1,19 @@
+#include "SymbolTable.h"
+
+int SymbolTable::add(const Component& component) {
+    int id = components.size();
+    components.push_back(component);
+    auto it = ids.find(component.name);
+    if (it != ids.end()) {
+        it->second = id;
+    } else {
+        names.push_back(component.name);
+        ids.emplace(names.back(), id);
+    }
+    return id;
+}
+
+int SymbolTable::find(std::string_view name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? npos : it->second;
+}
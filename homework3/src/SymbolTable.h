@@ -0,0 +1,43 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Represents a generic component in the netlist (e.g., input, output, wire)
+struct Component {
+    std::string type;
+    std::string name;
+    int width;
+    bool isSigned;
+    bool declaredSigned = false; // Int vs UInt as written; isSigned is forced off for 1-bit signals
+    bool isReg = false;
+    bool isNew = false;
+};
+
+// Interns every declared identifier to a dense id, the index of its Component.
+// Lookups hash the name once; later stages carry the id instead of the string.
+class SymbolTable {
+public:
+    // Id returned for constants, empty operands and undeclared names
+    static constexpr int npos = -1;
+
+    // Declares the component and returns its id; a redeclared name resolves to its latest declaration
+    int add(const Component& component);
+    int find(std::string_view name) const;
+
+    Component& operator[](int id) { return components[id]; }
+    const Component& operator[](int id) const { return components[id]; }
+    size_t size() const { return components.size(); }
+    const std::vector<Component>& entries() const { return components; }
+
+private:
+    std::vector<Component> components;
+    std::deque<std::string> names;                    // stable storage for the keys below
+    std::unordered_map<std::string_view, int> ids;
+};
+
+#endif // SYMBOLTABLE_H
@@ -1,4 +1,5 @@
 #include "VerilogGenerator.h"
+#include "trace.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm> // For std::remove_if
@@ -7,6 +8,10 @@
 #include <ctime>
 #include <iostream>
 #include <cmath>
+#include <map>
+#include <set>
+#include <stack>
+#include <unordered_map>
 
 std::string decimalToBinary(int decimal, int bitWidth) {
     std::string binary = "";
@@ -24,20 +29,164 @@ std::string decimalToBinary(int decimal, int bitWidth) {
     return binary;
 }
 
-VerilogGenerator::VerilogGenerator(const std::vector<Component>& components, const std::vector<Operation>& operations, Graph* graph)
-    : components(components), operations(operations), graph(graph) {}
+VerilogGenerator::VerilogGenerator(const std::vector<Component>& components, const std::vector<Operation>& operations, Graph* graph, int64_t initiationInterval)
+    : components(components), operations(operations), graph(graph), initiationInterval(initiationInterval), stageCount(0) {}
+
+namespace {
+
+// Right-hand side of an operation line "result <= rhs;"
+std::string rightHandSide(const std::string& line) {
+    size_t assign = line.find(" <= ");
+    size_t end = line.rfind(';');
+    return line.substr(assign + 4, end - assign - 4);
+}
+
+}
+
+void VerilogGenerator::resolveChaining() {
+    size_t count = this->graph->vertices.size();
+    this->chainWires.assign(count, "");
+    this->chainedExpressions.assign(count, "");
+
+    for (const auto& vertex : this->graph->vertices) {
+        if (vertex->operation.opType == "IF") {
+            continue;
+        }
+        // Producers chained into the vertex within its state; each operand reads the last of them in program order
+        std::unordered_map<std::string, Node*> producers;
+        std::stack<Node*> to_visit;
+        to_visit.push(vertex);
+        while (!to_visit.empty()) {
+            Node* chained = to_visit.top();
+            to_visit.pop();
+            for (const auto& predecessor : chained->prev) {
+                if (start_distance(predecessor, chained) != 0 || predecessor->fds_time != vertex->fds_time) {
+                    continue;
+                }
+                Node*& producer = producers[predecessor->output];
+                if (producer == nullptr || producer->operation.order < predecessor->operation.order) {
+                    producer = predecessor;
+                }
+                to_visit.push(predecessor);
+            }
+        }
+        if (producers.empty()) {
+            continue;
+        }
+
+        std::istringstream tokens(rightHandSide(vertex->operation.line));
+        std::string token;
+        std::string expression;
+        bool substituted = false;
+        while (std::getline(tokens, token, ' ')) {
+            auto it = producers.find(token);
+            if (it != producers.end()) {
+                Node* producer = it->second;
+                this->chainWires[producer->id] = producer->output + "_chain" + std::to_string(producer->id);
+                token = this->chainWires[producer->id];
+                substituted = true;
+            }
+            expression += (expression.empty() ? "" : " ") + token;
+        }
+        if (substituted) {
+            this->chainedExpressions[vertex->id] = expression;
+        }
+    }
+}
+
+std::string VerilogGenerator::stateAssignment(const Node* vertex) const {
+    if (!this->chainWires[vertex->id].empty()) {
+        return vertex->output + " <= " + this->chainWires[vertex->id] + ";";
+    }
+    if (!this->chainedExpressions[vertex->id].empty()) {
+        return vertex->output + " <= " + this->chainedExpressions[vertex->id] + ";";
+    }
+    return vertex->operation.line;
+}
+
+std::vector<std::pair<std::string, bool>> VerilogGenerator::guardConditions(const Node* vertex) const {
+    std::vector<std::pair<std::string, bool>> guard;
+    if (vertex->operation.condition.empty()) {
+        return guard;
+    }
+    guard.push_back({vertex->operation.condition, vertex->operation.enter_branch});
+
+    // Walk up through the IFs computing each condition, stopping at the top level or a cycle
+    const Node *tmp_vertex = vertex;
+    std::set<std::string> visited;
+    for (size_t i = 0; i < this->graph->vertices.size(); i++) {
+        bool found = false;
+        for (const auto& Othervertex : this->graph->vertices) {
+            if (tmp_vertex->operation.name != Othervertex->operation.name &&
+                Othervertex->operation.opType == "IF" &&
+                !tmp_vertex->operation.condition.empty() &&
+                tmp_vertex->operation.condition == Othervertex->operation.result) {
+                if (visited.find(Othervertex->operation.name) != visited.end()) {
+                    #if defined(ENABLE_LOGGING)
+                    std::cout << "Cycle detected, stopping traversal." << std::endl;
+                    #endif
+                    break;
+                }
+                if (Othervertex->operation.condition != "") {
+                    guard.push_back({Othervertex->operation.condition, Othervertex->operation.enter_branch});
+                }
+                visited.insert(tmp_vertex->operation.name);
+                tmp_vertex = Othervertex;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            break;
+        }
+    }
+    return guard;
+}
+
+std::string VerilogGenerator::stageName(const std::string& name, int64_t stage) const {
+    // Constants stay as they are, an output leaves the last stage into its port
+    if (this->stageRanges.count(name) == 0 || (stage == this->stageCount && this->outputPorts.count(name) != 0)) {
+        return name;
+    }
+    return name + "_s" + std::to_string(stage);
+}
+
+std::string VerilogGenerator::stageAssignment(const Node* vertex, int64_t readStage, int64_t writeStage) const {
+    // The result goes to the register of the stage holding the next cycle, the operands come from the current stage
+    std::istringstream tokens(vertex->operation.line);
+    std::string token;
+    std::string assignment;
+    bool target = true;
+    while (std::getline(tokens, token, ' ')) {
+        bool terminated = !token.empty() && token.back() == ';';
+        std::string name = terminated ? token.substr(0, token.size() - 1) : token;
+        if (!name.empty()) {
+            name = this->stageName(name, target ? writeStage : readStage);
+        }
+        target = false;
+        assignment += (assignment.empty() ? "" : " ") + name + (terminated ? ";" : "");
+    }
+    return assignment;
+}
 
 void VerilogGenerator::generateVerilog(const std::string& outputPath, const std::string& moduleName) {
     std::ofstream outFile(outputPath);
+    this->generateVerilog(outFile, moduleName);
+}
+
+void VerilogGenerator::generateVerilog(std::ostream& outFile, const std::string& moduleName) {
+    TraceSpan span("verilog", "emit Verilog");
     std::stringstream moduleDecl, declarations;
     auto now = std::chrono::system_clock::now();
     std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
+    char timeText[26]; // ctime_r rather than std::ctime, whose static buffer batch jobs would share
+    ctime_r(&currentTime, timeText);
     std::string widthSpecifier;
 
     // Write system log info
     moduleDecl << "// Generated by University of Arizona - ECE 574 - HLS Tool\n"
             << "// Authors: Mustafa Ghanim and Umut Suluhan\n"
-            << "// Date and Time: " << std::ctime(&currentTime)  << "\n"; // ctime includes a newline at the end
+            << "// Date and Time: " << timeText  << "\n"; // ctime includes a newline at the end
     // Start module declaration
     moduleDecl <<"`timescale 1ns / 1ps\n" << "module " << moduleName << "(\n";
     moduleDecl << "\tinput Clk, Rst, Start,\n"; 
@@ -60,6 +209,36 @@ void VerilogGenerator::generateVerilog(const std::string& outputPath, const std:
         // }
     }
 
+    // Results chained into a later operation of the same state are computed on a wire
+    this->resolveChaining();
+    std::unordered_map<std::string, const Component*> componentsByName;
+    for (const auto& component : components) {
+        componentsByName[component.name] = &component;
+    }
+    std::stringstream chainAssignments;
+    for (const auto& vertex : this->graph->vertices) {
+        const std::string& wire = this->chainWires[vertex->id];
+        if (wire.empty()) {
+            continue;
+        }
+        auto component = componentsByName.find(vertex->output);
+        std::string signModifier = component != componentsByName.end() && component->second->isSigned ? " signed" : "";
+        int width = component != componentsByName.end() ? component->second->width : vertex->datawidth;
+        widthSpecifier = (width > 1) ? " [" + std::to_string(width - 1) + ":0]" : "";
+        declarations << "\twire" << signModifier << widthSpecifier << " " << wire << ";\n";
+        std::string expression = this->chainedExpressions[vertex->id].empty() ? rightHandSide(vertex->operation.line) : this->chainedExpressions[vertex->id];
+        chainAssignments << "\tassign " << wire << " = " << expression << ";\n";
+    }
+
+    if (this->initiationInterval > 0) {
+        std::stringstream sequential = this->generatePipelinedCode(declarations);
+        std::string moduleDeclStr = moduleDecl.str();
+        moduleDeclStr = moduleDeclStr.substr(0, moduleDeclStr.rfind(',')) + "\n);";
+        outFile << moduleDeclStr << "\n" << declarations.str() << "\n" << sequential.str() << "\n";
+        outFile << "endmodule\n";
+        return;
+    }
+
     std::vector<int64_t>scheduled_times;
     int64_t state_counter = 0;
     for(const auto& vertex : this->graph->vertices){
@@ -103,6 +282,9 @@ void VerilogGenerator::generateVerilog(const std::string& outputPath, const std:
     moduleDeclStr = moduleDeclStr.substr(0, moduleDeclStr.rfind(',')) + "\n);";
     
     outFile << moduleDeclStr << "\n" << declarations.str() << "\n";
+    if (chainAssignments.tellp() > 0) {
+        outFile << chainAssignments.str() << "\n";
+    }
 
     std::stringstream sequential = this->generateSequentialCode(state_counter - 1);
 
@@ -260,45 +442,10 @@ std::stringstream VerilogGenerator::generateSequentialCode(int64_t state_counter
             std::string nested_condition;
             if (vertex->fds_time == state - 1) {
                 if(vertex->operation.condition != ""){
-                     Node *tmp_vertex = vertex;
-                    std::set<std::string> visited; // To track visited nodes and prevent cycles
-                    for (int i = 0; i <  this->graph->vertices.size(); i++) {
-                        bool found = false; // Flag to check if we should break the outer loop
-
-                        for (const auto& Othervertex : this->graph->vertices) {
-                            // Ensure we're looking at a different vertex that matches the needed condition
-                            if (tmp_vertex->operation.name != Othervertex->operation.name &&
-                                Othervertex->operation.opType == "IF" &&
-                                !tmp_vertex->operation.condition.empty() &&
-                                tmp_vertex->operation.condition == Othervertex->operation.result) {
-
-                                // Prevent cycles by checking if we've already visited this node
-                                if (visited.find(Othervertex->operation.name) != visited.end()) {
-                                    #if defined(ENABLE_LOGGING)  
-                                    std::cout << "Cycle detected, stopping traversal." << std::endl;
-                                    #endif 
-                                    break; // Break inner loop to stop processing further
-                                }
-
-                                // Append condition based on the branch type
-                                if (Othervertex->operation.enter_branch && Othervertex->operation.condition!="") {
-                                    nested_condition += " && " + Othervertex->operation.condition;
-                                } else if (!Othervertex->operation.enter_branch && Othervertex->operation.condition!="") {
-                                    nested_condition += " && !" + Othervertex->operation.condition;
-                                }
-
-                                // Move to the next vertex and mark the current one as visited
-                                visited.insert(tmp_vertex->operation.name);
-                                tmp_vertex = Othervertex;
-                                found = true; // Mark that we have found a next vertex
-                                break; // Break inner loop since we are changing the tmp_vertex
-                            }
-                        }
-
-                        // If no valid next vertex was found, break the outer loop
-                        if (!found) {
-                            break;
-                        }
+                    // Conditions of the enclosing branches
+                    std::vector<std::pair<std::string, bool>> guard = this->guardConditions(vertex);
+                    for (size_t iter = 1; iter < guard.size(); iter++) {
+                        nested_condition += std::string(" && ") + (guard[iter].second ? "" : "!") + guard[iter].first;
                     }
                 }                   
                 /*if(vertex->operation.opType == "IF"){
@@ -318,13 +465,13 @@ std::stringstream VerilogGenerator::generateSequentialCode(int64_t state_counter
                         else {
                             sequential << "\t\t\t\t\t\t" << "if (!" << vertex->operation.condition + nested_condition <<") begin"  << "\n";
                         }    
-                        sequential << "\t\t\t\t\t\t\t" << vertex->operation.line  << "\n";
+                        sequential << "\t\t\t\t\t\t\t" << this->stateAssignment(vertex)  << "\n";
                         sequential << "\t\t\t\t\t\t" << "end"  << "\n";
 
 
                     }
                     else
-                        sequential << "\t\t\t\t\t\t" << vertex->operation.line << "\n";
+                        sequential << "\t\t\t\t\t\t" << this->stateAssignment(vertex) << "\n";
                     
                 } 
 
@@ -361,3 +508,158 @@ std::stringstream VerilogGenerator::generateSequentialCode(int64_t state_counter
     return sequential;
     
 }
+
+// Pipelined datapath of a modulo schedule. Stage k runs the cycles k * II to (k + 1) * II - 1
+// of the schedule for the input set it holds, and every value has one register per stage it
+// lives in: an operation reads the registers of its stage and writes the one of the stage
+// holding the next cycle, and when the last slot of a stage ends all registers move on one
+// stage, the inputs into stage 0 and the outputs of the last stage into the ports. valid
+// marks the stages holding an input set; their operations only run while it is set.
+std::stringstream VerilogGenerator::generatePipelinedCode(std::stringstream& declarations) {
+    int64_t ii = this->initiationInterval;
+    int64_t length = 1;
+    for (const auto& vertex : this->graph->vertices) {
+        length = std::max(length, vertex->fds_time + vertex->latency);
+    }
+    this->stageCount = (length + ii - 1) / ii;
+    int64_t lastStage = this->stageCount - 1;
+
+    this->stageRanges.clear();
+    this->outputPorts.clear();
+    std::unordered_map<std::string, const Component*> componentsByName;
+    for (const auto& component : components) {
+        componentsByName[component.name] = &component;
+    }
+    auto live = [this, &componentsByName](const std::string& name, int64_t stage) {
+        if (componentsByName.count(name) == 0) {
+            return;
+        }
+        auto range = this->stageRanges.find(name);
+        if (range == this->stageRanges.end()) {
+            this->stageRanges[name] = {stage, stage};
+        } else {
+            range->second.first = std::min(range->second.first, stage);
+            range->second.second = std::max(range->second.second, stage);
+        }
+    };
+    for (const auto& component : components) {
+        if (component.type == "input") {
+            live(component.name, 0);
+        } else if (component.type == "output") {
+            live(component.name, this->stageCount);
+            this->outputPorts.insert(component.name);
+        }
+    }
+    std::map<int64_t, std::vector<Node*>> cycles;
+    for (const auto& vertex : this->graph->vertices) {
+        if (vertex->operation.opType == "IF") {
+            continue;
+        }
+        int64_t stage = vertex->fds_time / ii;
+        live(vertex->output, (vertex->fds_time + 1) / ii);
+        for (const auto& operand : vertex->operation.operands) {
+            live(operand, stage);
+        }
+        for (const auto& condition : this->guardConditions(vertex)) {
+            live(condition.first, stage);
+        }
+        cycles[vertex->fds_time].push_back(vertex);
+    }
+
+    // Stage registers of every value, in the order of the components
+    std::vector<std::pair<std::string, int64_t>> registers;
+    for (const auto& component : components) {
+        auto range = this->stageRanges.find(component.name);
+        if (range == this->stageRanges.end()) {
+            continue;
+        }
+        std::string signModifier = component.isSigned ? " signed" : "";
+        std::string widthSpecifier = (component.width > 1) ? " [" + std::to_string(component.width - 1) + ":0]" : "";
+        for (int64_t stage = range->second.first; stage <= range->second.second; stage++) {
+            if (this->stageName(component.name, stage) == component.name) {
+                continue;
+            }
+            declarations << "\treg" << signModifier << widthSpecifier << " " << this->stageName(component.name, stage) << ";\n";
+            registers.push_back({component.name, stage});
+        }
+    }
+
+    int64_t slot_width = std::max<int64_t>(1, std::ceil(std::log2(ii)));
+    std::string widthSpecifier = (slot_width > 1) ? " [" + std::to_string(slot_width - 1) + ":0]" : "";
+    declarations << "\n\t// " << this->stageCount << " stages, a new input set every " << ii << " cycles\n";
+    declarations << "\treg" << widthSpecifier << " slot;\n";
+    declarations << "\treg [" << lastStage << ":0] valid;\n";
+    declarations << "\twire advance = slot == " << ii - 1 << ";\n";
+
+    std::stringstream sequential;
+    sequential << "\talways @(posedge Clk) begin\n";
+    sequential << "\t\tif (Rst) begin\n";
+    // An empty pipeline waits in the last slot, so Start is taken at once
+    sequential << "\t\t\tslot <= " << ii - 1 << ";\n";
+    sequential << "\t\t\tvalid <= 0;\n";
+    sequential << "\t\t\tDone <= 0;\n";
+    for (const auto& component : components) {
+        if (component.type == "output") {
+            sequential << "\t\t\t" << component.name << " <= 0;\n";
+        }
+    }
+    for (const auto& value : registers) {
+        sequential << "\t\t\t" << this->stageName(value.first, value.second) << " <= 0;\n";
+    }
+    sequential << "\t\tend\n";
+    sequential << "\t\telse begin\n";
+
+    std::string earlier = lastStage > 0 ? "valid[" + std::to_string(lastStage - 1) + ":0]" : "";
+    sequential << "\t\t\tDone <= advance && valid[" << lastStage << "];\n";
+    sequential << "\t\t\tif (advance) begin\n";
+    sequential << "\t\t\t\tvalid <= " << (lastStage > 0 ? "{" + earlier + ", Start}" : "Start") << ";\n";
+    sequential << "\t\t\t\tslot <= " << (lastStage > 0 ? "Start || |" + earlier : "Start") << " ? 0 : " << ii - 1 << ";\n";
+    std::stringstream ports;
+    for (const auto& value : registers) {
+        const std::string& name = value.first;
+        int64_t stage = value.second;
+        if (stage == 0 && componentsByName[name]->type == "input") {
+            sequential << "\t\t\t\t" << this->stageName(name, 0) << " <= " << name << ";\n";
+        }
+        if (stage == this->stageRanges[name].second) {
+            continue;
+        }
+        std::string next = this->stageName(name, stage + 1);
+        (next == name ? ports : sequential) << (next == name ? "\t\t\t\t\t" : "\t\t\t\t") << next << " <= " << this->stageName(name, stage) << ";\n";
+    }
+    if (ports.tellp() > 0) {
+        sequential << "\t\t\t\tif (valid[" << lastStage << "]) begin\n";
+        sequential << ports.str();
+        sequential << "\t\t\t\tend\n";
+    }
+    sequential << "\t\t\tend\n";
+    sequential << "\t\t\telse begin\n";
+    sequential << "\t\t\t\tslot <= slot + 1;\n";
+    sequential << "\t\t\tend\n";
+
+    // Operations come after the moves, so a result written in the last slot of a stage wins over them
+    for (const auto& cycle : cycles) {
+        int64_t stage = cycle.first / ii;
+        int64_t writeStage = (cycle.first + 1) / ii;
+        sequential << "\t\t\tif (valid[" << stage << "]" << (ii > 1 ? " && slot == " + std::to_string(cycle.first % ii) : "") << ") begin\n";
+        for (const auto& vertex : cycle.second) {
+            std::vector<std::pair<std::string, bool>> guard = this->guardConditions(vertex);
+            if (guard.empty()) {
+                sequential << "\t\t\t\t" << this->stageAssignment(vertex, stage, writeStage) << "\n";
+                continue;
+            }
+            std::string condition;
+            for (const auto& term : guard) {
+                condition += (condition.empty() ? "" : " && ") + std::string(term.second ? "" : "!") + this->stageName(term.first, stage);
+            }
+            sequential << "\t\t\t\tif (" << condition << ") begin\n";
+            sequential << "\t\t\t\t\t" << this->stageAssignment(vertex, stage, writeStage) << "\n";
+            sequential << "\t\t\t\tend\n";
+        }
+        sequential << "\t\t\tend\n";
+    }
+
+    sequential << "\t\tend\n";
+    sequential << "\tend\n";
+    return sequential;
+}
@@ -4,18 +4,45 @@
 
 #include "NetlistParser.h"
 #include "graph.h"
+#include <ostream>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 class VerilogGenerator {
 public:
-    VerilogGenerator(const std::vector<Component>& components, const std::vector<Operation>& operations, Graph* graph);
+    // A positive initiation interval emits a pipeline taking an input set every that many
+    // cycles instead of the FSM (the graph has to be modulo scheduled at that interval)
+    VerilogGenerator(const std::vector<Component>& components, const std::vector<Operation>& operations, Graph* graph, int64_t initiationInterval = 0);
     void generateVerilog(const std::string& outputPath, const std::string& moduleName);
+    // Writes the module into any stream (a file, a string buffer, ...)
+    void generateVerilog(std::ostream& outFile, const std::string& moduleName);
 
 private:
     std::vector<Component> components;
     std::vector<Operation> operations;
     Graph* graph;
+    int64_t initiationInterval;
+    // By vertex id: wire carrying the result into operations chained in the same state,
+    // and the right-hand side with chained operands read from such wires (empty if unchanged)
+    std::vector<std::string> chainWires;
+    std::vector<std::string> chainedExpressions;
+    // Pipeline: stages of the schedule, by component name the first and last stage holding
+    // a register of the value, and the outputs, whose register past the last stage is the port
+    int64_t stageCount;
+    std::unordered_map<std::string, std::pair<int64_t, int64_t>> stageRanges;
+    std::unordered_set<std::string> outputPorts;
     std::stringstream generateSequentialCode(int64_t state_counter);
+    std::stringstream generatePipelinedCode(std::stringstream& declarations);
+    void resolveChaining();
+    std::string stateAssignment(const Node* vertex) const;
+    // Conditions guarding the vertex, innermost first, with the branch taken (true in the if body)
+    std::vector<std::pair<std::string, bool>> guardConditions(const Node* vertex) const;
+    std::string stageName(const std::string& name, int64_t stage) const;
+    std::string stageAssignment(const Node* vertex, int64_t readStage, int64_t writeStage) const;
 };
 
 #endif // VERILOGGENERATOR_H
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "batch.h"
+#include "IrCache.h"
+#include "VerilogGenerator.h"
+#include "graph.h"
+#include "fds.h"
+#include "list_scheduler.h"
+#include "hls_error.h"
+#include "trace.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void compile_job(const BatchJob& job, const std::string& scheduler, const std::vector<int64_t>& resource_limits, const std::string& cache_dir, BatchResult& result) {
+    TraceSpan span("batch", "job");
+    span.arg("file", job.c_file);
+    span.arg("latency", job.latency);
+    if (!fs::exists(job.c_file)) {
+        throw HlsError("Error: Netlist file '" + job.c_file + "' does not exist.");
+    }
+    CompiledDesign design = compileDesign(job.c_file, cache_dir);
+    result.warnings = design.warnings;
+
+    Graph graph(design.graph, job.latency);
+    if (scheduler == "list") {
+        ListScheduler list_scheduler(&graph, job.latency, resource_limits);
+        list_scheduler.run_list_scheduler();
+    } else {
+        FDS fds(&graph, job.latency);
+        fds.run_force_directed_scheduler();
+    }
+
+    VerilogGenerator verilog_generator(design.components, design.graph.operations, &graph);
+    verilog_generator.generateVerilog(job.verilog_file, "HLSM");
+}
+
+}
+
+std::vector<BatchJob> read_batch_manifest(const std::string& path) {
+    std::ifstream manifest(path);
+    if (!manifest.is_open()) {
+        throw HlsError("Error: Unable to read batch manifest '" + path + "'");
+    }
+    fs::path base = fs::path(path).parent_path();
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(manifest, line)) {
+        line_number++;
+        std::istringstream fields(line);
+        std::string c_file;
+        if (!(fields >> c_file) || c_file[0] == '#') {
+            continue;
+        }
+        BatchJob job;
+        std::string extra;
+        if (!(fields >> job.latency >> job.verilog_file) || (fields >> extra) || job.latency < 1) {
+            throw HlsError("Error: Expected '<cFile> <latency> <verilogFile>' at line " + std::to_string(line_number) + " of batch manifest '" + path + "'");
+        }
+        job.c_file = (base / c_file).string();
+        job.verilog_file = (base / job.verilog_file).string();
+        job.line = line_number;
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+std::vector<BatchResult> run_batch(const std::vector<BatchJob>& jobs, const std::string& scheduler, const std::vector<int64_t>& resource_limits, const std::string& cache_dir, ThreadPool& pool) {
+    std::vector<BatchResult> results(jobs.size());
+    TaskGroup group;
+    for (size_t index = 0; index < jobs.size(); index++) {
+        pool.run(group, [&jobs, &results, &scheduler, &resource_limits, &cache_dir, index]() {
+            BatchResult& result = results[index];
+            auto start = std::chrono::steady_clock::now();
+            try {
+                compile_job(jobs[index], scheduler, resource_limits, cache_dir, result);
+                result.ok = true;
+            } catch (const std::exception& error) {
+                result.message = error.what();
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    pool.wait(group);
+    return results;
+}
+
+size_t print_batch_report(const std::vector<BatchJob>& jobs, const std::vector<BatchResult>& results, double seconds, std::ostream& out) {
+    size_t failed = 0;
+    for (size_t index = 0; index < jobs.size(); index++) {
+        for (const auto& warning : results[index].warnings) {
+            out << "WARNING line " << jobs[index].line << " (" << jobs[index].c_file << "): " << warning << "\n";
+        }
+        if (!results[index].ok) {
+            failed++;
+            out << "FAILED line " << jobs[index].line << " (" << jobs[index].c_file << ", latency " << jobs[index].latency << "): " << results[index].message << "\n";
+        }
+    }
+    out << "Compiled " << jobs.size() - failed << " of " << jobs.size() << " jobs in " << std::fixed << std::setprecision(2) << seconds << " s";
+    if (failed > 0) {
+        out << ", " << failed << " failed";
+    }
+    out << "\n";
+    return failed;
+}
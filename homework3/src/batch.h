@@ -0,0 +1,36 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+
+// One line of a batch manifest
+struct BatchJob {
+    std::string c_file;
+    int64_t latency;
+    std::string verilog_file;
+    int line;   // line in the manifest, for the report
+};
+
+struct BatchResult {
+    bool ok = false;
+    std::string message;   // why the job failed, empty on success
+    std::vector<std::string> warnings;   // of the parser, see CompiledDesign
+    double seconds = 0.0;
+};
+
+// Reads "<cFile> <latency> <verilogFile>" lines, skipping blank lines and '#' comments.
+// Relative paths are taken relative to the manifest. Throws HlsError on a malformed line.
+std::vector<BatchJob> read_batch_manifest(const std::string& path);
+
+// Compiles every job on the pool, one task per job. Each job parses (or loads the IR cached in cache_dir),
+// schedules and writes its Verilog with its own state; a failing job only fails its own result.
+std::vector<BatchResult> run_batch(const std::vector<BatchJob>& jobs, const std::string& scheduler, const std::vector<int64_t>& resource_limits, const std::string& cache_dir, ThreadPool& pool);
+
+// Lists the parser warnings, the failed jobs and a summary line; returns the number of failed jobs
+size_t print_batch_report(const std::vector<BatchJob>& jobs, const std::vector<BatchResult>& results, double seconds, std::ostream& out);
+
+#endif
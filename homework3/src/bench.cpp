@@ -0,0 +1,248 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "design_generator.h"
+#include "NetlistParser.h"
+#include "OpPostProcess.h"
+#include "IrOptimizer.h"
+#include "VerilogGenerator.h"
+#include "graph.h"
+#include "fds.h"
+#include "list_scheduler.h"
+#include "sweep.h"
+#include "thread_pool.h"
+#include "hls_error.h"
+
+namespace {
+
+struct BenchOptions {
+    DesignShape shape;
+    std::vector<int64_t> sizes;
+    std::string scheduler = "fds";
+    std::vector<int64_t> resource_limits;
+    int64_t latency = 0;     // 0 schedules at the critical path plus slack percent
+    int64_t slack = 20;
+    int64_t threads = 1;
+    double clock_period = 0.0;   // ns, chains operations when positive
+    std::string emit_path;
+};
+
+struct PhaseTime {
+    const char* name;
+    double seconds;
+    long peak_rss_kb;      // peak resident set of the process at the end of the phase
+};
+
+long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+class PhaseTimer {
+public:
+    explicit PhaseTimer(std::vector<PhaseTime>& phases) : phases(phases) {}
+
+    template <typename Step>
+    void run(const char* name, Step step) {
+        auto start = std::chrono::steady_clock::now();
+        step();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        this->phases.push_back({name, seconds, peak_rss_kb()});
+    }
+
+private:
+    std::vector<PhaseTime>& phases;
+};
+
+void print_phases(const std::vector<PhaseTime>& phases, int64_t operations, std::ostream& out) {
+    double total = 0.0;
+    out << "  " << std::left << std::setw(16) << "phase" << std::right << std::setw(12) << "time ms" << std::setw(14) << "ops/s" << std::setw(16) << "peak RSS MB" << "\n";
+    for (const auto& phase : phases) {
+        total += phase.seconds;
+        out << "  " << std::left << std::setw(16) << phase.name << std::right << std::fixed << std::setprecision(2) << std::setw(12) << phase.seconds * 1000.0
+            << std::setprecision(0) << std::setw(14) << operations / std::max(phase.seconds, 1e-9)
+            << std::setprecision(1) << std::setw(16) << phase.peak_rss_kb / 1024.0 << "\n";
+    }
+    out << "  " << std::left << std::setw(16) << "total" << std::right << std::fixed << std::setprecision(2) << std::setw(12) << total * 1000.0
+        << std::setprecision(0) << std::setw(14) << operations / std::max(total, 1e-9)
+        << std::setprecision(1) << std::setw(16) << (phases.empty() ? 0 : phases.back().peak_rss_kb) / 1024.0 << "\n";
+}
+
+// Generates, compiles and schedules one design, timing every phase of the pipeline
+void bench_design(const BenchOptions& options, int64_t operations, ThreadPool* pool, std::ostream& out) {
+    std::vector<PhaseTime> phases;
+    PhaseTimer timer(phases);
+    DesignShape shape = options.shape;
+    shape.operations = operations;
+
+    GeneratedDesign generated;
+    timer.run("generate", [&]() { generated = generate_design(shape); });
+    if (!options.emit_path.empty()) {
+        std::ofstream emitted(options.emit_path);
+        if (!(emitted << generated.source)) {
+            throw HlsError("Error: Unable to write generated design '" + options.emit_path + "'");
+        }
+    }
+
+    NetlistParser parser("");
+    timer.run("parse", [&]() { parser.parseSource(generated.source); });
+    timer.run("optimize", [&]() { optimizeOperations(parser); });
+    OperationGraph opGraph;
+    timer.run("OpPostProcess", [&]() { opGraph = OpPostProcess("bench", parser); });
+
+    const std::vector<int64_t>& resource_limits = options.resource_limits;
+    int64_t latency = options.latency;
+    int64_t lower_bound = 0;
+    timer.run("latency bound", [&]() {
+        if (options.scheduler == "list") {
+            LatencySearch search = find_minimum_latency(opGraph, true, resource_limits, options.clock_period);
+            lower_bound = search.lower_bound;
+            // The list schedule length is tight already
+            latency = latency == 0 ? search.latency : latency;
+            return;
+        }
+        // Only ASAP, the FDS walk of find_minimum_latency costs as much as the schedule itself
+        Graph reference(opGraph, 1, options.clock_period);
+        FDS reference_fds(&reference, 1);
+        reference_fds.compute_topological_order();
+        reference_fds.asap_scheduler();
+        lower_bound = reference_fds.critical_path();
+        latency = latency == 0 ? lower_bound + lower_bound * options.slack / 100 : latency;
+    });
+
+    // Shown before the graph is built, whose probability vectors grow with operations x latency
+    out << generated.operations << " operations (depth " << generated.depth << ", width " << generated.width << ", " << generated.branches << " if statements, "
+        << generated.source.size() << " bytes of source), " << options.scheduler << " at latency " << latency << " (critical path " << lower_bound << ")" << std::endl;
+
+    std::unique_ptr<Graph> graph;
+    timer.run("build graph", [&]() { graph = std::make_unique<Graph>(opGraph, latency, options.clock_period); });
+    timer.run("schedule", [&]() {
+        if (options.scheduler == "list") {
+            ListScheduler list_scheduler(graph.get(), latency, resource_limits);
+            list_scheduler.run_list_scheduler();
+        } else {
+            FDS fds(graph.get(), latency, pool);
+            fds.run_force_directed_scheduler();
+        }
+    });
+    std::ostringstream verilog;
+    timer.run("Verilog", [&]() {
+        VerilogGenerator verilog_generator(parser.getComponents(), opGraph.operations, graph.get());
+        verilog_generator.generateVerilog(verilog, "HLSM");
+    });
+
+    print_phases(phases, generated.operations, out);
+}
+
+std::vector<int64_t> parse_sizes(const std::string& text) {
+    std::vector<int64_t> sizes;
+    std::istringstream fields(text);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        int64_t size = 0;
+        try {
+            size = std::stoll(field);
+        } catch (const std::exception&) {
+        }
+        if (size < 1 || size > 100000) {
+            throw HlsError("Error: Operation count '" + field + "' must be between 1 and 100000");
+        }
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+int run(int argc, char** argv) {
+    BenchOptions options;
+    options.resource_limits = ListScheduler::parse_resource_limits("");
+    std::string sizes = "10000";
+    bool usage = false;
+    for (int iter = 1; iter < argc; iter++) {
+        std::string argument = argv[iter];
+        if (iter + 1 >= argc) {
+            usage = true;
+        } else if (argument == "--ops") {
+            sizes = argv[++iter];
+        } else if (argument == "--seed") {
+            options.shape.seed = std::stoull(argv[++iter]);
+        } else if (argument == "--depth") {
+            options.shape.depth = std::stoll(argv[++iter]);
+        } else if (argument == "--width") {
+            options.shape.width = std::stoll(argv[++iter]);
+        } else if (argument == "--if-density") {
+            options.shape.if_density = std::stod(argv[++iter]);
+        } else if (argument == "--nesting") {
+            options.shape.max_nesting = std::stoll(argv[++iter]);
+        } else if (argument == "--mix") {
+            parse_operation_mix(argv[++iter], options.shape);
+        } else if (argument == "--scheduler") {
+            options.scheduler = argv[++iter];
+        } else if (argument == "--resources") {
+            options.resource_limits = ListScheduler::parse_resource_limits(argv[++iter]);
+        } else if (argument == "--latency") {
+            options.latency = std::stoll(argv[++iter]);
+        } else if (argument == "--slack") {
+            options.slack = std::stoll(argv[++iter]);
+        } else if (argument == "--threads") {
+            options.threads = std::stoll(argv[++iter]);
+        } else if (argument == "--clock-period") {
+            options.clock_period = std::stod(argv[++iter]);
+        } else if (argument == "--emit") {
+            options.emit_path = argv[++iter];
+        } else {
+            usage = true;
+        }
+    }
+    if (!usage) {
+        options.sizes = parse_sizes(sizes);
+    }
+    if (usage || options.sizes.empty() || (options.scheduler != "fds" && options.scheduler != "list") || options.shape.depth < 0 || options.shape.width < 0 ||
+        options.shape.if_density < 0.0 || options.shape.if_density > 1.0 || options.shape.max_nesting < 0 || options.latency < 0 || options.slack < 0 || options.clock_period < 0.0 ||
+        options.threads < 1 || (!options.emit_path.empty() && options.sizes.size() > 1)) {
+        std::cerr << "Usage: " << argv[0] << " [--ops N[,N...]] [--seed S] [--depth D] [--width W] [--if-density P] [--nesting N]\n";
+        std::cerr << "       [--mix add=4,sub=2,mul=2,div=1,mod=1,cmp=1,mux=1,shift=1] [--scheduler fds|list] [--resources ...]\n";
+        std::cerr << "       [--latency N | --slack PERCENT] [--clock-period NS] [--threads N] [--emit <cFile>]\n";
+        std::cerr << "       Generates a random design per operation count (at most 100000) and times every compiler phase;\n";
+        std::cerr << "       --emit writes the generated source of a single design\n";
+        return 1;
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threads > 1) {
+        pool = std::make_unique<ThreadPool>(options.threads);
+    }
+    std::cout << "hlsyn_bench seed " << options.shape.seed << ", if density " << options.shape.if_density << ", nesting " << options.shape.max_nesting << ", mix";
+    for (const auto& entry : options.shape.mix) {
+        std::cout << " " << entry.first << "=" << entry.second;
+    }
+    std::cout << "\n";
+    // Smaller designs first, so the peak RSS of each one is not hidden by a bigger predecessor
+    std::sort(options.sizes.begin(), options.sizes.end());
+    for (int64_t size : options.sizes) {
+        std::cout << "\n";
+        bench_design(options, size, pool.get(), std::cout);
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    try {
+        return run(argc, argv);
+    } catch (const HlsError& error) {
+        (error.exit_code() == 0 ? std::cout : std::cerr) << error.what() << std::endl;
+        return error.exit_code();
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <queue>
+
+#include "chaining.h"
+#include "graph.h"
+#include "resource_library.h"
+
+namespace {
+
+// Both operations run under the same branch, or the producer under none
+bool same_guard(const Node* predecessor, const Node* successor) {
+    const Operation& from = predecessor->operation;
+    const Operation& to = successor->operation;
+    return from.condition.empty() || (from.condition == to.condition && from.enter_branch == to.enter_branch);
+}
+
+}
+
+void assign_chain_groups(Graph& graph, double clock_period) {
+    const ResourceLibrary& library = ResourceLibrary::instance();
+    size_t count = graph.vertices.size();
+    std::vector<double> delay(count, -1.0);
+    std::vector<double> arrival(count, 0.0);   // longest delay of a path inside the group ending at the vertex
+    std::vector<size_t> pending(count);
+    std::queue<Node*> ready;
+    for (const auto& vertex : graph.vertices) {
+        vertex->chain_group = -1;
+        if (vertex->latency == 1) {
+            delay[vertex->id] = library.delay(vertex->operation.opType, vertex->datawidth);
+        }
+        pending[vertex->id] = vertex->prev.size();
+        if (vertex->prev.empty()) {
+            ready.push(vertex);
+        }
+    }
+
+    int next_group = 0;
+    while (!ready.empty()) {
+        Node* vertex = ready.front();
+        ready.pop();
+        for (const auto& successor : vertex->next) {
+            if (--pending[successor->id] == 0) {
+                ready.push(successor);
+            }
+        }
+        if (delay[vertex->id] < 0.0 || delay[vertex->id] > clock_period) {
+            continue;
+        }
+
+        // Join the predecessor group that leaves the most slack; every predecessor in
+        // that group becomes a chained edge, so all of them have to fit
+        int best_group = -1;
+        double best_arrival = 0.0;
+        for (const auto& candidate : vertex->prev) {
+            int group = candidate->chain_group;
+            if (group < 0) {
+                continue;
+            }
+            double group_arrival = 0.0;
+            bool fits = true;
+            for (const auto& predecessor : vertex->prev) {
+                if (predecessor->chain_group == group) {
+                    fits = fits && same_guard(predecessor, vertex);
+                    group_arrival = std::max(group_arrival, arrival[predecessor->id]);
+                }
+            }
+            group_arrival += delay[vertex->id];
+            if (fits && group_arrival <= clock_period && (best_group < 0 || group_arrival < best_arrival)) {
+                best_group = group;
+                best_arrival = group_arrival;
+            }
+        }
+        if (best_group < 0) {
+            best_group = next_group++;
+            best_arrival = delay[vertex->id];
+        }
+        vertex->chain_group = best_group;
+        arrival[vertex->id] = best_arrival;
+    }
+}
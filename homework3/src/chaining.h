@@ -0,0 +1,13 @@
+#ifndef CHAINING_H
+#define CHAINING_H
+
+class Graph;
+
+// Groups dependent single-cycle operations that may share a state when the clock
+// period is clock_period ns: along every dependency path inside a group the summed
+// delay from the ResourceLibrary fits the period. Edges inside a group let the
+// successor start in the state its predecessor runs in (see start_distance). Operations of different branches
+// are never grouped, so a chained value is only used under the guard it was made in.
+void assign_chain_groups(Graph& graph, double clock_period);
+
+#endif
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "dependency_graph.h"
+
+namespace {
+
+// Counting sort of the edges by key node into offsets/indices, stable in the edge order
+void build_rows(size_t num_nodes, const std::vector<std::pair<int, int>>& edges, bool by_source, std::vector<int>& offsets, std::vector<int>& indices) {
+    offsets.assign(num_nodes + 1, 0);
+    for (const auto& edge : edges) {
+        offsets[(by_source ? edge.first : edge.second) + 1]++;
+    }
+    for (size_t node = 0; node < num_nodes; node++) {
+        offsets[node + 1] += offsets[node];
+    }
+
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    indices.resize(edges.size());
+    for (const auto& edge : edges) {
+        int key = by_source ? edge.first : edge.second;
+        indices[cursor[key]++] = by_source ? edge.second : edge.first;
+    }
+}
+
+}
+
+DependencyGraph::DependencyGraph(size_t num_nodes, const std::vector<std::pair<int, int>>& edges) {
+    build_rows(num_nodes, edges, true, fanout_offsets, fanout_indices);
+    build_rows(num_nodes, edges, false, fanin_offsets, fanin_indices);
+}
+
+size_t DependencyGraph::size() const {
+    return fanout_offsets.empty() ? 0 : fanout_offsets.size() - 1;
+}
+
+size_t DependencyGraph::num_edges() const {
+    return fanout_indices.size();
+}
+
+IdRange DependencyGraph::successors(int id) const {
+    return IdRange(fanout_indices.data() + fanout_offsets[id], fanout_indices.data() + fanout_offsets[id + 1]);
+}
+
+IdRange DependencyGraph::predecessors(int id) const {
+    return IdRange(fanin_indices.data() + fanin_offsets[id], fanin_indices.data() + fanin_offsets[id + 1]);
+}
+
+std::vector<bool> find_transitive_edges(size_t num_nodes, const std::vector<std::pair<int, int>>& edges) {
+    std::vector<bool> transitive(edges.size(), false);
+    DependencyGraph graph(num_nodes, edges);
+
+    // Kahn's algorithm; topo_index orders the bitset columns
+    std::vector<int> order;
+    std::vector<int> pending(num_nodes);
+    order.reserve(num_nodes);
+    for (size_t node = 0; node < num_nodes; node++) {
+        pending[node] = graph.predecessors(node).size();
+        if (pending[node] == 0) {
+            order.push_back(node);
+        }
+    }
+    for (size_t head = 0; head < order.size(); head++) {
+        for (int successor : graph.successors(order[head])) {
+            if (--pending[successor] == 0) {
+                order.push_back(successor);
+            }
+        }
+    }
+    if (order.size() != num_nodes) {
+        return transitive;
+    }
+    std::vector<int> topo_index(num_nodes);
+    for (size_t index = 0; index < num_nodes; index++) {
+        topo_index[order[index]] = index;
+    }
+
+    // Position of every edge inside the fan-out rows, to map row entries back to edges
+    std::vector<std::vector<size_t>> edge_ids(num_nodes);
+    for (size_t edge = 0; edge < edges.size(); edge++) {
+        edge_ids[edges[edge].first].push_back(edge);
+    }
+
+    const size_t block_words = 16;
+    const size_t block_size = block_words * 64;
+    std::vector<uint64_t> reach(num_nodes * block_words);
+    std::vector<uint64_t> implied(block_words);
+    for (size_t block_start = 0; block_start < num_nodes; block_start += block_size) {
+        size_t block_end = std::min(num_nodes, block_start + block_size);
+        std::fill(reach.begin(), reach.end(), 0);
+        // Only nodes before the block in topological order can reach into it
+        for (size_t index = block_end; index-- > 0;) {
+            int node = order[index];
+            uint64_t* row = &reach[node * block_words];
+            std::fill(implied.begin(), implied.end(), 0);
+            for (size_t edge : edge_ids[node]) {
+                const uint64_t* successor_row = &reach[edges[edge].second * block_words];
+                for (size_t word = 0; word < block_words; word++) {
+                    implied[word] |= successor_row[word];
+                }
+            }
+            std::copy(implied.begin(), implied.end(), row);
+            for (size_t edge : edge_ids[node]) {
+                size_t column = topo_index[edges[edge].second];
+                if (column < block_start || column >= block_end) {
+                    continue;
+                }
+                column -= block_start;
+                // The target is reachable through another successor
+                if (implied[column / 64] & (uint64_t(1) << (column % 64))) {
+                    transitive[edge] = true;
+                }
+                row[column / 64] |= uint64_t(1) << (column % 64);
+            }
+        }
+    }
+    return transitive;
+}
@@ -0,0 +1,82 @@
+#ifndef DEPENDENCY_GRAPH_H
+#define DEPENDENCY_GRAPH_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Contiguous run of node ids inside a CSR index array
+class IdRange {
+public:
+    IdRange() : first(nullptr), last(nullptr) {}
+    IdRange(const int* first, const int* last) : first(first), last(last) {}
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    int operator[](size_t index) const { return first[index]; }
+
+private:
+    const int* first;
+    const int* last;
+};
+
+// IdRange that dereferences the ids into an array of node pointers, so a CSR
+// neighbourhood can be iterated like a std::vector<T*>
+template <typename T>
+class NodeRange {
+public:
+    class iterator {
+    public:
+        iterator(const int* position, T* const* nodes) : position(position), nodes(nodes) {}
+        T* operator*() const { return nodes[*position]; }
+        iterator& operator++() { ++position; return *this; }
+        bool operator!=(const iterator& other) const { return position != other.position; }
+        bool operator==(const iterator& other) const { return position == other.position; }
+
+    private:
+        const int* position;
+        T* const* nodes;
+    };
+
+    NodeRange() : nodes(nullptr) {}
+    NodeRange(IdRange ids, T* const* nodes) : ids(ids), nodes(nodes) {}
+
+    iterator begin() const { return iterator(ids.begin(), nodes); }
+    iterator end() const { return iterator(ids.end(), nodes); }
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+    T* operator[](size_t index) const { return nodes[ids[index]]; }
+
+private:
+    IdRange ids;
+    T* const* nodes;
+};
+
+// Immutable DAG over dense node ids 0..size()-1, stored as compressed sparse rows:
+// the fan-out (fan-in) of node i is indices[offsets[i] .. offsets[i+1]).
+// Built from an edge list in O(V + E); neighbours keep the order of the edge list.
+class DependencyGraph {
+public:
+    DependencyGraph() = default;
+    DependencyGraph(size_t num_nodes, const std::vector<std::pair<int, int>>& edges);
+
+    size_t size() const;
+    size_t num_edges() const;
+    IdRange successors(int id) const;
+    IdRange predecessors(int id) const;
+
+private:
+    std::vector<int> fanout_offsets;
+    std::vector<int> fanout_indices;
+    std::vector<int> fanin_offsets;
+    std::vector<int> fanin_indices;
+};
+
+// Marks the edges implied by a longer path (the edges a transitive reduction drops).
+// Reachability is propagated in reverse topological order over bitsets, a block of
+// target nodes at a time to bound memory. Returns no marks if the edges form a cycle.
+std::vector<bool> find_transitive_edges(size_t num_nodes, const std::vector<std::pair<int, int>>& edges);
+
+#endif
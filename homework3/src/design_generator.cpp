@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+#include "design_generator.h"
+#include "hls_error.h"
+
+namespace {
+
+const int64_t inputCount = 16;
+
+// Writes "kind name0, name1, ..." lines of at most 16 names
+void declare(std::ostringstream& out, const std::string& kind, const std::string& prefix, int64_t count) {
+    for (int64_t first = 0; first < count; first += 16) {
+        out << kind;
+        for (int64_t index = first; index < std::min(count, first + 16); index++) {
+            out << (index == first ? " " : ", ") << prefix << index;
+        }
+        out << "\n";
+    }
+}
+
+}
+
+void parse_operation_mix(const std::string& text, DesignShape& shape) {
+    for (auto& entry : shape.mix) {
+        entry.second = 0;
+    }
+    int64_t total = 0;
+    std::istringstream fields(text);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        size_t equals = field.find('=');
+        std::string name = field.substr(0, equals);
+        auto entry = std::find_if(shape.mix.begin(), shape.mix.end(), [&name](const auto& candidate) { return candidate.first == name; });
+        if (equals == std::string::npos || entry == shape.mix.end()) {
+            throw HlsError("Error: Unknown operation mix entry '" + field + "', expected add|sub|mul|div|mod|cmp|mux|shift=<weight>");
+        }
+        try {
+            entry->second = std::stoll(field.substr(equals + 1));
+        } catch (const std::exception&) {
+            entry->second = -1;
+        }
+        if (entry->second < 0) {
+            throw HlsError("Error: Invalid weight in operation mix entry '" + field + "'");
+        }
+        total += entry->second;
+    }
+    if (total == 0) {
+        throw HlsError("Error: Operation mix '" + text + "' has no positive weight");
+    }
+}
+
+GeneratedDesign generate_design(const DesignShape& shape) {
+    GeneratedDesign design;
+    int64_t operations = std::max<int64_t>(1, shape.operations);
+    if (shape.depth > 0) {
+        design.depth = std::min(shape.depth, operations);
+        design.width = shape.width > 0 ? shape.width : (operations + design.depth - 1) / design.depth;
+    } else if (shape.width > 0) {
+        design.width = std::min(shape.width, operations);
+        design.depth = (operations + design.width - 1) / design.width;
+    } else {
+        design.depth = std::max<int64_t>(1, std::llround(std::sqrt(static_cast<double>(operations))));
+        design.width = (operations + design.depth - 1) / design.depth;
+    }
+    operations = std::min(operations, design.depth * design.width);
+
+    std::mt19937_64 random(shape.seed);
+    auto uniform = [&random](int64_t count) { return std::uniform_int_distribution<int64_t>(0, count - 1)(random); };
+    auto chance = [&random](double probability) { return std::uniform_real_distribution<double>(0.0, 1.0)(random) < probability; };
+    std::vector<int64_t> weights;
+    for (const auto& entry : shape.mix) {
+        weights.push_back(entry.second);
+    }
+    std::discrete_distribution<size_t> pick_kind(weights.begin(), weights.end());
+
+    // Values of the last level are the outputs, everything before it a variable
+    int64_t last_level = (operations - 1) / design.width * design.width;
+    auto value = [last_level](int64_t index) { return index >= last_level ? "o" + std::to_string(index - last_level) : "v" + std::to_string(index); };
+    // A value of an earlier level, or now and then an input
+    auto earlier = [&](int64_t level) {
+        if (level == 0 || chance(0.25)) {
+            return "i" + std::to_string(uniform(inputCount));
+        }
+        return value(uniform(level * design.width));
+    };
+
+    std::ostringstream body;
+    struct Block {
+        int64_t remaining;   // statements left in the current branch
+        bool has_else;
+    };
+    std::vector<Block> blocks;
+    auto indent = [&blocks]() { return std::string(4 * blocks.size(), ' '); };
+    auto block_length = [&uniform]() { return 1 + uniform(8); };
+
+    for (int64_t index = 0; index < operations; index++) {
+        int64_t level = index / design.width;
+        if (static_cast<int64_t>(blocks.size()) < shape.max_nesting && chance(shape.if_density)) {
+            std::string condition = "c" + std::to_string(design.branches++);
+            body << indent() << condition << " = " << earlier(level) << " > " << earlier(level) << "\n";
+            body << indent() << "if ( " << condition << " ) {\n";
+            blocks.push_back({block_length(), chance(0.5)});
+            design.operations++;
+        }
+
+        std::string first = level == 0 ? earlier(0) : value((level - 1) * design.width + uniform(design.width));
+        std::string second = earlier(level);
+        body << indent() << value(index) << " = ";
+        const std::string& kind = shape.mix[pick_kind(random)].first;
+        if (kind == "add") {
+            body << first << " + " << second;
+        } else if (kind == "sub") {
+            body << first << " - " << second;
+        } else if (kind == "mul") {
+            body << first << " * " << second;
+        } else if (kind == "div") {
+            body << first << " / " << second;
+        } else if (kind == "mod") {
+            body << first << " % " << second;
+        } else if (kind == "cmp") {
+            const char* symbols[] = {" > ", " < ", " == "};
+            body << first << symbols[uniform(3)] << second;
+        } else if (kind == "mux") {
+            body << first << " ? " << second << " : " << earlier(level);
+        } else {
+            body << first << (chance(0.5) ? " >> " : " << ") << second;
+        }
+        body << "\n";
+        design.operations++;
+
+        // A finished branch counts as one statement of the enclosing one
+        while (!blocks.empty() && --blocks.back().remaining <= 0) {
+            if (blocks.back().has_else) {
+                blocks.back() = {block_length(), false};
+                body << indent().substr(4) << "}\n" << indent().substr(4) << "else {\n";
+                break;
+            }
+            blocks.pop_back();
+            body << indent() << "}\n";
+        }
+    }
+    while (!blocks.empty()) {
+        blocks.pop_back();
+        body << indent() << "}\n";
+    }
+
+    std::ostringstream out;
+    declare(out, "input Int32", "i", inputCount);
+    declare(out, "output Int32", "o", operations - last_level);
+    declare(out, "variable Int32", "v", last_level);
+    declare(out, "variable Int1", "c", design.branches);
+    out << "\n" << body.str();
+    design.source = out.str();
+    return design;
+}
@@ -0,0 +1,38 @@
+#ifndef DESIGN_GENERATOR_H
+#define DESIGN_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Shape of a random design in the C subset accepted by NetlistParser
+struct DesignShape {
+    uint64_t seed = 1;
+    int64_t operations = 10000;   // data operations laid out on the depth x width grid
+    int64_t depth = 0;            // levels of the grid; 0 derives it from width, or uses sqrt(operations)
+    int64_t width = 0;            // operations per level; 0 derives it from depth
+    double if_density = 0.05;     // chance that an if ( c ) { ... } opens before an operation
+    int64_t max_nesting = 3;      // deepest nesting of if/else blocks
+    // Relative weights of add, sub, mul, div, mod, cmp, mux and shift operations
+    std::vector<std::pair<std::string, int64_t>> mix = {
+        {"add", 4}, {"sub", 2}, {"mul", 2}, {"div", 1}, {"mod", 1}, {"cmp", 1}, {"mux", 1}, {"shift", 1}};
+};
+
+struct GeneratedDesign {
+    std::string source;
+    int64_t depth = 0;
+    int64_t width = 0;
+    int64_t operations = 0;   // grid operations plus the comparisons feeding if conditions
+    int64_t branches = 0;     // if statements
+};
+
+// Parses "add=4,mul=2,..." into the mix of a shape; unnamed classes get weight 0. Throws HlsError.
+void parse_operation_mix(const std::string& text, DesignShape& shape);
+
+// Operations on level k read a value of level k-1 and a value of any earlier level or an
+// input, so the longest dependency chain runs through every level. The same shape and
+// seed always give the same source.
+GeneratedDesign generate_design(const DesignShape& shape);
+
+#endif
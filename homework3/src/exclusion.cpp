@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include "exclusion.h"
+#include "graph.h"
+
+MutualExclusion::MutualExclusion(const Graph& graph) : arms(graph.vertices.size(), 0), parents(1, 0) {
+    // IFs testing each condition
+    std::unordered_map<std::string, std::vector<const Node*>> tests;
+    for (const auto& vertex : graph.vertices) {
+        if (vertex->operation.opType == "IF") {
+            tests[vertex->operation.result].push_back(vertex);
+        }
+    }
+
+    std::unordered_map<std::string, int> enclosing;        // arm holding the IFs of each condition
+    std::map<std::pair<int, std::string>, int> conditions;  // index of each condition by enclosing arm and name
+    std::function<int(const std::string&, bool)> guard_arm = [&](const std::string& condition, bool enter_branch) {
+        if (condition.empty()) {
+            return 0;
+        }
+        if (enclosing.find(condition) == enclosing.end()) {
+            // A condition that guards its own IF ends up at the top level
+            enclosing[condition] = 0;
+            int outer = -1;
+            for (const auto& test : tests[condition]) {
+                int arm = guard_arm(test->operation.condition, test->operation.enter_branch);
+                outer = outer < 0 || outer == arm ? arm : 0;
+            }
+            enclosing[condition] = std::max(outer, 0);
+        }
+        int outer = enclosing[condition];
+        auto key = std::make_pair(outer, condition);
+        auto found = conditions.find(key);
+        if (found == conditions.end()) {
+            int index = conditions.size();
+            found = conditions.emplace(key, index).first;
+            this->parents.push_back(outer);
+            this->parents.push_back(outer);
+        }
+        return 2 * found->second + (enter_branch ? 1 : 2);
+    };
+
+    for (const auto& vertex : graph.vertices) {
+        this->arms[vertex->id] = guard_arm(vertex->operation.condition, vertex->operation.enter_branch);
+    }
+}
+
+int MutualExclusion::arm_of(const Node* node) const {
+    return this->arms[node->id];
+}
+
+int64_t MutualExclusion::combine(std::map<int, int64_t>& demand) const {
+    // Inner arms have larger numbers than the arms they are nested in
+    while (!demand.empty() && demand.rbegin()->first > 0) {
+        auto arm = std::prev(demand.end());
+        int64_t larger = arm->second;
+        auto other = demand.find(sibling(arm->first));
+        if (other != demand.end()) {
+            larger = std::max(larger, other->second);
+            demand.erase(other);
+        }
+        int outer = this->parent(arm->first);
+        demand.erase(arm);
+        demand[outer] += larger;
+    }
+    return demand.empty() ? 0 : demand.begin()->second;
+}
@@ -0,0 +1,42 @@
+#ifndef EXCLUSION_H
+#define EXCLUSION_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class Graph;
+class Node;
+
+// If/else arms of the operations of a graph. Arm 0 holds the operations outside any
+// branch; condition k has the arms 2k+1 (if body) and 2k+2 (else body), nested in the
+// arm of the IF that computes it. Operations of the two arms of one condition are guarded
+// by the same condition register in opposite polarity, so they never run in the same state
+// and may share a unit: the demand of an arm is that of its own operations plus, for every
+// condition nested in it, the larger demand of the condition's two arms.
+//
+// A condition tested by IFs under different guards is placed at the top level, which only
+// gives up sharing with the arms around it.
+class MutualExclusion {
+public:
+    explicit MutualExclusion(const Graph& graph);
+
+    // Arm of the vertex by Node::id
+    int arm_of(const Node* node) const;
+    size_t arm_count() const { return this->parents.size(); }
+    bool has_branches() const { return this->parents.size() > 1; }
+    // Arm the condition of a non-zero arm is nested in, always a smaller arm
+    int parent(int arm) const { return this->parents[arm]; }
+    // Other arm of the same condition
+    static int sibling(int arm) { return arm % 2 == 1 ? arm + 1 : arm - 1; }
+
+    // Folds the demand of each arm into the top level: the demand of a set of operations
+    // that are busy in one cycle, given as their count per arm
+    int64_t combine(std::map<int, int64_t>& demand) const;
+
+private:
+    std::vector<int> arms;
+    std::vector<int> parents;
+};
+
+#endif
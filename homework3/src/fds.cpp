@@ -3,32 +3,61 @@
 #include <fstream>
 #include <sstream>
 #include <stack>
+#include <queue>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "fds.h"
+#include "hls_error.h"
+#include "trace.h"
+#include "force_kernel.h"
 
-FDS::FDS(Graph* graph, int64_t latency_requirement){
+FDS::FDS(Graph* graph, int64_t latency_requirement, ThreadPool* pool) : exclusion(*graph){
     this->graph = graph;
     this->latency_requirement = latency_requirement;
+    this->pool = pool;
 
-    // Might be handled better later...
-    // 0: ADD_SUB, 1: MUL, 2: LOG, 3:DIV_MOD
-    for(int iter = 0; iter < latency_requirement; iter++){
-        this->add_sub_prob.push_back(0.0);
-        this->mul_prob.push_back(0.0);
-        this->log_prob.push_back(0.0);
-        this->div_mod_prob.push_back(0.0);
-    }
+    this->num_resources = ResourceRegistry::instance().size();
+    this->type_dist.assign(this->num_resources * latency_requirement, 0.0);
 
+    // Rows for the arms holding an operation of a class and the arms around them
+    this->arm_rows.assign(this->exclusion.arm_count() * this->num_resources, -1);
+    int64_t rows = 0;
+    for (const auto& vertex : this->graph->vertices) {
+        for(int arm = this->exclusion.arm_of(vertex); arm != 0; arm = this->exclusion.parent(arm)){
+            int64_t& row = this->arm_rows[arm * this->num_resources + vertex->resource_id];
+            if(row >= 0){
+                break;
+            }
+            row = rows++;
+        }
+    }
+    this->arm_dist.assign(rows * latency_requirement, 0.0);
 }
 
 Graph* FDS::run_force_directed_scheduler(){
+    this->compute_topological_order();
     this->asap_scheduler();
     this->alap_scheduler();
+    this->schedule_time_frames();
+    if(!this->meets_latency_requirement()){
+        throw HlsError("Couldn't meet the latency requirement of " + std::to_string(this->latency_requirement) + " cycles! Increase the latency, exiting ...", HlsErrorKind::unschedulable);
+    }
+    return this->graph;
+}
+
+Graph* FDS::schedule_time_frames(){
+    // Expects asap_time/alap_time of every vertex to be set and the topological order computed
+    TraceSpan span("schedule", "FDS");
+    span.arg("latency", this->latency_requirement);
+    span.arg("vertices", this->graph->vertices.size());
     this->assign_time_frames();
     this->calculate_fds_prob();
     this->calculate_type_dist();
 
 #if defined(ENABLE_LOGGING)  
+    std::cout << "Self force kernel: " << self_force_kernel_name() << std::endl;
     this->print_asap();
     this->print_alap();
     this->print_time_frames();
@@ -44,60 +73,74 @@ Graph* FDS::run_force_directed_scheduler(){
 #if defined(ENABLE_LOGGING)  
     this->print_fds_times();
 #endif
+    return this->graph;
+}
+
+bool FDS::meets_latency_requirement(){
     for(const auto& vertex : this->graph->vertices){
-        if(vertex->next.size() == 0){
-            if(vertex->fds_time + vertex->latency <= this->latency_requirement){
-                continue;
-            }else{
-                std::cout << "Couldn't meet the latency requirement of " << this->latency_requirement << " cycles! Increase the latency, exiting ..." << std::endl;
-                exit(0);
-            }
+        if(vertex->next.size() == 0 && vertex->fds_time + vertex->latency > this->latency_requirement){
+            return false;
         }
     }
-    return this->graph;
+    return true;
 }
 
 void FDS::asap_scheduler(){
-    for (const auto& vertex : this->graph->vertices) {
+    TraceSpan span("schedule", "ASAP");
+    // An operation can start once its latest predecessor finished
+    for (const auto& vertex : this->topo_order) {
         for(const auto& sub_vertex : vertex->next){
-            sub_vertex->asap_time = vertex->asap_time + vertex->latency;
+            sub_vertex->asap_time = std::max(sub_vertex->asap_time, vertex->asap_time + start_distance(vertex, sub_vertex));
         }
     }
 }
 
 void FDS::alap_scheduler(){
-    int alap_time = this->graph->latency_requirement;
-    for (int iter = this->graph->vertices.size() - 1; iter >= 0; iter--) {
-        int smallest_alap = 1000;
-        int smallest_alap_latency;
-        if(this->graph->vertices.at(iter)->next.size() == 0){
-            continue;
-        }else{
-            for (const auto& vertex : this->graph->vertices.at(iter)->next) {
-                if(vertex->alap_time < smallest_alap){
-                    smallest_alap = vertex->alap_time;
-                    smallest_alap_latency = vertex->latency;
-                }
+    TraceSpan span("schedule", "ALAP");
+    for (auto it = this->topo_order.rbegin(); it != this->topo_order.rend(); ++it) {
+        Node *vertex = *it;
+        if(vertex->next.size() != 0){
+            int64_t smallest_alap = INT64_MAX;
+            for (const auto& sub_vertex : vertex->next) {
+                smallest_alap = std::min(smallest_alap, sub_vertex->alap_time - start_distance(vertex, sub_vertex));
             }
-            if(smallest_alap - this->graph->vertices.at(iter)->latency <= 0){
-                std::cout << "Cannot schedule the circuit for " << this->latency_requirement << " cycle latency , increase the latency! Exiting ..." << std::endl;
-                exit(0); 
-            }
-            this->graph->vertices.at(iter)->alap_time = smallest_alap - this->graph->vertices.at(iter)->latency;
+            vertex->alap_time = smallest_alap;
+        }
+        if(vertex->alap_time <= 0){
+            throw HlsError("Cannot schedule the circuit for " + std::to_string(this->latency_requirement) + " cycle latency , increase the latency! Exiting ...", HlsErrorKind::unschedulable);
         }
     }
 }
 
+int64_t FDS::critical_path(){
+    // Smallest latency that fits the ASAP schedule
+    int64_t length = 0;
+    for (const auto& vertex : this->graph->vertices) {
+        length = std::max(length, vertex->asap_time + vertex->latency - 1);
+    }
+    return length;
+}
+
 void FDS::assign_time_frames(){
+    this->class_vertices.assign(this->num_resources, {});
+    this->class_window.assign(this->num_resources, 0);
     for (const auto& vertex : this->graph->vertices) {
         vertex->time_frame[0] = vertex->asap_time;
         vertex->time_frame[1] = vertex->alap_time;
         vertex->fds_width = vertex->time_frame[1] - vertex->time_frame[0] + 1;
+        this->class_vertices[vertex->resource_id].push_back(vertex);
+        this->class_window[vertex->resource_id] = std::max(this->class_window[vertex->resource_id], vertex->fds_width);
+    }
+    for (auto& vertices : this->class_vertices) {
+        std::stable_sort(vertices.begin(), vertices.end(), [](const Node* a, const Node* b) {
+            return a->asap_time < b->asap_time;
+        });
     }
 }
 
 void FDS::calculate_fds_prob(){
     for (const auto& vertex : this->graph->vertices) {
+        std::fill(vertex->fds_prob.begin(), vertex->fds_prob.end(), 0.0);
         double prob = 1.0 / vertex->fds_width;
         for(int iter = vertex->time_frame[0]; iter < vertex->time_frame[1]+1; iter++){
             vertex->fds_prob.at(iter-1) = prob;
@@ -106,26 +149,90 @@ void FDS::calculate_fds_prob(){
 }
 
 void FDS::calculate_type_dist(){
+    std::fill(this->type_dist.begin(), this->type_dist.end(), 0.0);
+    std::fill(this->arm_dist.begin(), this->arm_dist.end(), 0.0);
+
     for (const auto& vertex : this->graph->vertices) {
-        if(vertex->type == "ADD_SUB"){
-            for(int iter = 0; iter < this->latency_requirement; iter++){
-                this->add_sub_prob.at(iter) += vertex->fds_prob.at(iter);
-            }
-        }else if(vertex->type == "MUL"){
-            for(int iter = 0; iter < this->latency_requirement; iter++){
-                this->mul_prob.at(iter) += vertex->fds_prob.at(iter);
-            }
-        }else if(vertex->type == "LOG"){
-            for(int iter = 0; iter < this->latency_requirement; iter++){
-                this->log_prob.at(iter) += vertex->fds_prob.at(iter);
-            }
-        }else if(vertex->type == "DIV_MOD"){
-            for(int iter = 0; iter < this->latency_requirement; iter++){
-                this->div_mod_prob.at(iter) += vertex->fds_prob.at(iter);
-            }
-        }else{
-            std::cout << "No " << vertex->type << " is not in the type list!!!" << std::endl;
-            exit(0);
+        for(int iter = 0; iter < this->latency_requirement; iter++){
+            this->add_demand(vertex, iter, vertex->fds_prob.at(iter));
+        }
+    }
+}
+
+double* FDS::type_distribution(int resource_id){
+    // Row of the distribution matrix holding one resource class over all cycles
+    return this->type_dist.data() + resource_id * this->latency_requirement;
+}
+
+double* FDS::arm_distribution(int arm, int resource_id){
+    int64_t row = this->arm_rows[arm * this->num_resources + resource_id];
+    return row < 0 ? nullptr : this->arm_dist.data() + row * this->latency_requirement;
+}
+
+void FDS::add_demand(Node* node, int64_t slot, double probability){
+    // An arm passes a change on to its enclosing arm only as far as it changes the larger of the condition's two arms
+    double change = probability;
+    for(int arm = this->exclusion.arm_of(node); arm != 0 && change != 0.0; arm = this->exclusion.parent(arm)){
+        double *demand = this->arm_distribution(arm, node->resource_id);
+        const double *other = this->arm_distribution(MutualExclusion::sibling(arm), node->resource_id);
+        double other_demand = other != nullptr ? other[slot] : 0.0;
+        double before = std::max(demand[slot], other_demand);
+        demand[slot] += change;
+        change = std::max(demand[slot], other_demand) - before;
+    }
+    this->type_distribution(node->resource_id)[slot] += change;
+}
+
+void FDS::remove_from_distribution(Node* node){
+    int64_t start = std::max<int64_t>(node->time_frame[0], 1);
+    int64_t end = std::min<int64_t>(node->time_frame[1], this->latency_requirement);
+    for(int64_t iter = start; iter <= end; iter++){
+        this->add_demand(node, iter-1, -node->fds_prob[iter-1]);
+        node->fds_prob[iter-1] = 0.0;
+    }
+}
+
+void FDS::add_to_distribution(Node* node){
+    int64_t start = std::max<int64_t>(node->time_frame[0], 1);
+    int64_t end = std::min<int64_t>(node->time_frame[1], this->latency_requirement);
+    double prob = node->fds_width > 0 ? 1.0 / node->fds_width : 0.0;
+    for(int64_t iter = start; iter <= end; iter++){
+        node->fds_prob[iter-1] = prob;
+        this->add_demand(node, iter-1, prob);
+    }
+}
+
+void FDS::set_time_frame(Node* node, int64_t start, int64_t end){
+    if(node->time_frame[0] == start && node->time_frame[1] == end){
+        return;
+    }
+
+    // Only the slots of the old window can change in the type distribution
+    int64_t old_start = node->time_frame[0];
+    int64_t old_end = node->time_frame[1];
+
+    this->remove_from_distribution(node);
+    node->time_frame[0] = start;
+    node->time_frame[1] = end;
+    node->fds_width = std::max<int64_t>(0, end - start + 1);
+    this->add_to_distribution(node);
+
+    this->invalidate_node(node);
+    this->invalidate_overlapping(node->resource_id, std::min(old_start, start), std::max(old_end, end));
+}
+
+void FDS::invalidate_overlapping(int resource_id, int64_t start, int64_t end){
+    // Frames only narrow inside [asap, alap], so a vertex starting before start - window + 1
+    // ends before start, and one starting after end cannot reach the changed slots either
+    const std::vector<Node*>& vertices = this->class_vertices[resource_id];
+    int64_t earliest = start - this->class_window[resource_id] + 1;
+    auto first = std::lower_bound(vertices.begin(), vertices.end(), earliest, [](const Node* vertex, int64_t time) {
+        return vertex->asap_time < time;
+    });
+    for (auto it = first; it != vertices.end() && (*it)->asap_time <= end; ++it) {
+        Node *vertex = *it;
+        if(vertex->alap_time >= start && vertex->time_frame[0] <= end && vertex->time_frame[1] >= start){
+            this->invalidate_node(vertex);
         }
     }
 }
@@ -135,19 +242,40 @@ void FDS::perform_scheduling(){
     double tolerance = 0.01;
     
     for (const auto& vertex : this->graph->vertices) {
+        TraceSpan span("placement", "place");
         double minimum_total_force = 10000000.0;
         int64_t minimum_time = 0;
-        for(int possible_time = vertex->time_frame[0]; possible_time <= vertex->time_frame[1]; possible_time++){
-            double self_force = this->calculate_self_force(possible_time, vertex->time_frame, vertex->fds_prob, vertex->type, vertex->name);
-            double predecessor_force = 0.0;
-            double successor_force = 0.0;
-            if (vertex->prev.size() != 0){
-                predecessor_force = this->calculate_predecessor_force(vertex, possible_time, vertex->time_frame, vertex->fds_prob, vertex->type);
-            }
-            if (vertex->next.size() != 0){
-                successor_force = this->calculate_successor_force(vertex, possible_time, vertex->time_frame, vertex->fds_prob, vertex->type);
+        // Evaluate the shared state once, then score every candidate slot independently
+        this->force_evaluations += vertex->self_forces_valid ? 0 : 1;
+        this->refresh_self_forces(vertex);
+        if (vertex->prev.size() != 0){
+            this->predecessor_cone_force(vertex);
+        }
+        if (vertex->next.size() != 0){
+            this->successor_cone_force(vertex);
+        }
+        int64_t width = vertex->self_forces.size();
+        this->force_evaluations += width;
+        std::vector<double> total_forces(width);
+        this->parallel_for(width, 64, [this, vertex, &total_forces](size_t begin, size_t end) {
+            for(size_t iter = begin; iter < end; iter++){
+                int64_t possible_time = vertex->time_frame[0] + iter;
+                double self_force = vertex->self_forces[iter];
+                double predecessor_force = 0.0;
+                double successor_force = 0.0;
+                if (vertex->prev.size() != 0){
+                    predecessor_force = this->calculate_predecessor_force(vertex, possible_time);
+                }
+                if (vertex->next.size() != 0){
+                    successor_force = this->calculate_successor_force(vertex, possible_time);
+                }
+                total_forces[iter] = self_force + predecessor_force + successor_force;
             }
-            total_force = self_force + predecessor_force + successor_force;
+        });
+
+        // Pick the slot serially so ties break exactly as in the single-threaded scheduler
+        for(int possible_time = vertex->time_frame[0]; possible_time <= vertex->time_frame[1]; possible_time++){
+            total_force = total_forces[possible_time - vertex->time_frame[0]];
 
             if(total_force < minimum_total_force){
                 if (std::abs(total_force - minimum_total_force) < tolerance) {
@@ -159,109 +287,277 @@ void FDS::perform_scheduling(){
         }
         vertex->fds_time = minimum_time;
         this->update_time_frames(vertex);
-        this->calculate_fds_prob();
-        this->calculate_type_dist();
+        if (tracing()) {
+            span.arg("node", vertex->name);
+            span.arg("candidates", width);
+            span.arg("slot", minimum_time);
+            trace_counters("FDS work", {{"force evaluations", this->force_evaluations}, {"traversal nodes", this->traversal_nodes}});
+        }
     }
 }
 
-double FDS::calculate_self_force(int64_t possible_time, int64_t time_frame[], std::vector<double> fds_prob, std::string op_type, std::string name){
-    double self_force = 0;
-    size_t size = time_frame[1] - time_frame[0] + 1;
-    int64_t calculation_mask[size];
-
-    for(int iter = 0; iter < size; iter++){
-        calculation_mask[iter] = 0;
-    }
-
-    calculation_mask[possible_time - time_frame[0]] = 1;
-
-    for(int time = time_frame[0]; time <= time_frame[1]; time++){
-        if(op_type == "ADD_SUB"){
-            self_force += this->add_sub_prob.at(time - 1) * (calculation_mask[time - time_frame[0]] - fds_prob.at(time-1));
-        }else if(op_type == "MUL"){
-            self_force += this->mul_prob.at(time - 1) * (calculation_mask[time - time_frame[0]] - fds_prob.at(time-1));
-        }else if(op_type == "LOG"){
-            self_force += this->log_prob.at(time - 1) * (calculation_mask[time - time_frame[0]] - fds_prob.at(time-1));
-        }else if(op_type == "DIV_MOD"){
-            self_force += this->div_mod_prob.at(time - 1) * (calculation_mask[time - time_frame[0]] - fds_prob.at(time-1));
-        }else{
-            std::cout << "No type named " << op_type << " is present. Exiting at calculate_self_force" << std::endl;
-            exit(0);
+double FDS::calculate_predecessor_force(Node* node, int64_t possible_time){
+    // Force of the node's own earlier slots plus every slot of its predecessor cone
+    return this->self_force_before(node, possible_time) + this->predecessor_cone_force(node);
+}
+
+double FDS::calculate_successor_force(Node* node, int64_t possible_time){
+    // Force of the node's own later slots plus every slot of its successor cone
+    return this->self_force_after(node, possible_time) + this->successor_cone_force(node);
+}
+
+void FDS::compute_topological_order(){
+    std::unordered_map<Node*, size_t> pending;
+    std::queue<Node*> ready;
+
+    this->topo_order.clear();
+    for (const auto& vertex : this->graph->vertices) {
+        pending[vertex] = vertex->prev.size();
+        if(vertex->prev.empty()){
+            ready.push(vertex);
         }
     }
 
-    return self_force;
+    while(!ready.empty()){
+        Node *vertex = ready.front();
+        ready.pop();
+        vertex->topo_index = this->topo_order.size();
+        this->topo_order.push_back(vertex);
+        for (const auto& successor : vertex->next) {
+            if(--pending[successor] == 0){
+                ready.push(successor);
+            }
+        }
+    }
+
+    if(this->topo_order.size() != this->graph->vertices.size()){
+        throw HlsError("Dependency graph has a cycle, cannot schedule! Exiting ...", HlsErrorKind::invalid_design);
+    }
 }
 
-double FDS::calculate_predecessor_force(Node* node, int64_t possible_time, int64_t time_frame[], std::vector<double> fds_prob, std::string op_type){
-    double total_predecessor_force = 0.0;
-    
-    this->traverse_graph(node, possible_time, total_predecessor_force, "prev");
-    return total_predecessor_force;
+void FDS::refresh_self_forces(Node* node){
+    if(node->self_forces_valid){
+        return;
+    }
+
+    int64_t width = std::max<int64_t>(0, node->time_frame[1] - node->time_frame[0] + 1);
+    node->self_forces.resize(width);
+    node->self_force_prefix.resize(width + 1);
+    if(width > 0){
+        const double *type_prob = this->type_distribution(node->resource_id) + node->time_frame[0] - 1;
+        const double *fds_prob = node->fds_prob.data() + node->time_frame[0] - 1;
+        compute_self_forces(type_prob, fds_prob, width, node->self_forces.data());
+    }
+    node->self_force_prefix[0] = 0.0;
+    for(int64_t iter = 0; iter < width; iter++){
+        node->self_force_prefix[iter + 1] = node->self_force_prefix[iter] + node->self_forces[iter];
+    }
+    node->self_forces_valid = true;
 }
 
-double FDS::calculate_successor_force(Node* node, int64_t possible_time, int64_t time_frame[], std::vector<double> fds_prob, std::string op_type){
-    double total_successor_force = 0.0;
-    this->traverse_graph(node, possible_time, total_successor_force, "next");
-    return total_successor_force;
+double FDS::self_force_after(Node* node, int64_t earlier_time){
+    // Sum of the node's self forces over its slots later than earlier_time
+    this->refresh_self_forces(node);
+    int64_t width = node->self_forces.size();
+    int64_t first = std::clamp<int64_t>(earlier_time - node->time_frame[0] + 1, 0, width);
+    return node->self_force_prefix[width] - node->self_force_prefix[first];
 }
 
-void FDS::traverse_graph(Node *node, int64_t earlier_time, double &total_successor_force, std::string direction){
-    std::vector<Node*> dependencies; 
+double FDS::self_force_before(Node* node, int64_t later_time){
+    // Sum of the node's self forces over its slots earlier than later_time
+    this->refresh_self_forces(node);
+    int64_t width = node->self_forces.size();
+    int64_t last = std::clamp<int64_t>(later_time - node->time_frame[0], 0, width);
+    return node->self_force_prefix[last];
+}
 
-    if(direction == "next"){
-        dependencies = node->next;
-    }else if (direction == "prev"){
-        dependencies = node->prev;
-    }else{
-        std::cout << "No direction like " << direction << "! Exiting..." << std::endl;
-        exit(0);
+double FDS::successor_cone_force(Node* node){
+    if(!node->successor_cone_valid){
+        this->evaluate_cone(node, true);
+    }
+    return node->successor_cone;
+}
+
+double FDS::predecessor_cone_force(Node* node){
+    if(!node->predecessor_cone_valid){
+        this->evaluate_cone(node, false);
     }
+    return node->predecessor_cone;
+}
 
-    if(node->time_frame[0] == node->time_frame[1]){
-        if(direction == "next" && node->time_frame[0] > earlier_time){
-            total_successor_force += this->calculate_self_force(node->time_frame[0], node->time_frame, node->fds_prob, node->type, node->name);
-        }else if(direction == "prev" && node->time_frame[0] < earlier_time){
-            total_successor_force += this->calculate_self_force(node->time_frame[0], node->time_frame, node->fds_prob, node->type, node->name);
+void FDS::evaluate_cone(Node* node, bool successors){
+    auto cone_valid = [successors](const Node* vertex) {
+        return successors ? vertex->successor_cone_valid : vertex->predecessor_cone_valid;
+    };
+    auto dependencies = [successors](const Node* vertex) -> const NodeRange<Node>& {
+        return successors ? vertex->next : vertex->prev;
+    };
+
+    // Collect the stale part of the cone; valid nodes already hold their whole sub-cone
+    std::vector<Node*> stale;
+    std::unordered_set<Node*> visited;
+    std::stack<Node*> to_visit;
+    to_visit.push(node);
+    while(!to_visit.empty()){
+        Node *vertex = to_visit.top();
+        to_visit.pop();
+        if(cone_valid(vertex) || !visited.insert(vertex).second){
+            continue;
         }
+        stale.push_back(vertex);
+        for (const auto& dependency : dependencies(vertex)) {
+            to_visit.push(dependency);
+        }
+    }
+    this->traversal_nodes += visited.size();
+    this->force_evaluations += stale.size();
+
+    // Evaluate the far end of the cone first so every dependency is ready when it is needed
+    std::sort(stale.begin(), stale.end(), [successors](const Node* a, const Node* b) {
+        return successors ? a->topo_index > b->topo_index : a->topo_index < b->topo_index;
+    });
 
-        for (const auto& dependentNode : dependencies) {
-            traverse_graph(dependentNode, node->time_frame[0], total_successor_force, direction);
+    // Refresh the self-force rows read by the cone up front, so the levels below only read shared state
+    std::vector<Node*> rows;
+    std::unordered_set<Node*> seen_rows;
+    for (const auto& vertex : stale) {
+        for (const auto& dependency : dependencies(vertex)) {
+            if(!dependency->self_forces_valid && seen_rows.insert(dependency).second){
+                rows.push_back(dependency);
+            }
         }
-    }else{
-        for (int iter = node->time_frame[0]; iter <= node->time_frame[1]; iter++) {
-            if(direction == "next" && iter > earlier_time){
-                total_successor_force += this->calculate_self_force(iter, node->time_frame, node->fds_prob, node->type, node->name);
-            }else if(direction == "prev" && iter < earlier_time){
-                total_successor_force += this->calculate_self_force(iter, node->time_frame, node->fds_prob, node->type, node->name);
+    }
+    this->force_evaluations += rows.size();
+    this->parallel_for(rows.size(), 16, [this, &rows](size_t begin, size_t end) {
+        for(size_t iter = begin; iter < end; iter++){
+            this->refresh_self_forces(rows[iter]);
+        }
+    });
+
+    // Nodes of one level only depend on lower levels and can be evaluated concurrently
+    std::unordered_map<Node*, size_t> level_of;
+    std::vector<std::vector<Node*>> levels;
+    for (const auto& vertex : stale) {
+        size_t level = 0;
+        for (const auto& dependency : dependencies(vertex)) {
+            auto it = level_of.find(dependency);
+            if(it != level_of.end()){
+                level = std::max(level, it->second + 1);
             }
+        }
+        level_of[vertex] = level;
+        if(level >= levels.size()){
+            levels.resize(level + 1);
+        }
+        levels[level].push_back(vertex);
+    }
 
-            for (const auto& dependentNode : dependencies) {
-                traverse_graph(dependentNode, iter, total_successor_force, direction);
+    for (const auto& level : levels) {
+        this->parallel_for(level.size(), 16, [&](size_t begin, size_t end) {
+            for(size_t index = begin; index < end; index++){
+                Node *vertex = level[index];
+                int64_t width = std::max<int64_t>(0, vertex->time_frame[1] - vertex->time_frame[0] + 1);
+                double cone = 0.0;
+                for (const auto& dependency : dependencies(vertex)) {
+                    // A chained dependency may also take the slot of the vertex itself
+                    int64_t shared = (successors ? start_distance(vertex, dependency) : start_distance(dependency, vertex)) == 0 ? 1 : 0;
+                    for(int64_t iter = vertex->time_frame[0]; iter <= vertex->time_frame[1]; iter++){
+                        cone += successors ? this->self_force_after(dependency, iter - shared) : this->self_force_before(dependency, iter + shared);
+                    }
+                    cone += width * (successors ? dependency->successor_cone : dependency->predecessor_cone);
+                }
+                if(successors){
+                    vertex->successor_cone = cone;
+                    vertex->successor_cone_valid = true;
+                }else{
+                    vertex->predecessor_cone = cone;
+                    vertex->predecessor_cone_valid = true;
+                }
             }
+        });
+    }
+}
+
+void FDS::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body){
+    if(this->pool == nullptr){
+        body(0, count);
+    }else{
+        this->pool->parallel_for(0, count, grain, body);
+    }
+}
+
+void FDS::invalidate_node(Node* node){
+    node->self_forces_valid = false;
+    node->successor_cone_valid = false;
+    node->predecessor_cone_valid = false;
+
+    // Every ancestor sums this node into its successor cone, every descendant into its predecessor cone.
+    // A node whose cone is already stale has stale ancestors/descendants too, so the walk stops there.
+    std::stack<Node*> to_visit;
+    for (const auto& predecessor : node->prev) {
+        to_visit.push(predecessor);
+    }
+    while(!to_visit.empty()){
+        Node *vertex = to_visit.top();
+        to_visit.pop();
+        this->traversal_nodes++;
+        if(!vertex->successor_cone_valid){
+            continue;
+        }
+        vertex->successor_cone_valid = false;
+        for (const auto& predecessor : vertex->prev) {
+            to_visit.push(predecessor);
+        }
+    }
+
+    for (const auto& successor : node->next) {
+        to_visit.push(successor);
+    }
+    while(!to_visit.empty()){
+        Node *vertex = to_visit.top();
+        to_visit.pop();
+        this->traversal_nodes++;
+        if(!vertex->predecessor_cone_valid){
+            continue;
+        }
+        vertex->predecessor_cone_valid = false;
+        for (const auto& successor : vertex->next) {
+            to_visit.push(successor);
         }
     }
-    
 }
 
 void FDS::update_time_frames(Node* node){
-    node->time_frame[0] = node->fds_time;
-    node->time_frame[1] = node->fds_time;
+    // Each narrowed frame moves its probability window in the distribution graph,
+    // and the narrowing is carried through the whole cone so no dependency can be violated
+    this->set_time_frame(node, node->fds_time, node->fds_time);
 
-    if(node->prev.size() != 0){
-        for (const auto& vertex : node->prev) {
-            if(node->fds_time <= vertex->time_frame[1]){
-                vertex->time_frame[1] = node->fds_time - node->latency;
+    std::stack<Node*> to_visit;
+    to_visit.push(node);
+    while(!to_visit.empty()){
+        Node *vertex = to_visit.top();
+        to_visit.pop();
+        this->traversal_nodes++;
+        for (const auto& successor : vertex->next) {
+            int64_t earliest = vertex->time_frame[0] + start_distance(vertex, successor);
+            if(earliest > successor->time_frame[0]){
+                this->set_time_frame(successor, earliest, successor->time_frame[1]);
+                to_visit.push(successor);
             }
         }
     }
 
-    if(node->next.size() != 0){
-        for (const auto& vertex : node->next) {
-            if(node->fds_time >= vertex->time_frame[0]){
-                vertex->time_frame[0] = node->fds_time + node->latency;
+    to_visit.push(node);
+    while(!to_visit.empty()){
+        Node *vertex = to_visit.top();
+        to_visit.pop();
+        this->traversal_nodes++;
+        for (const auto& predecessor : vertex->prev) {
+            int64_t latest = vertex->time_frame[1] - start_distance(predecessor, vertex);
+            if(latest < predecessor->time_frame[1]){
+                this->set_time_frame(predecessor, predecessor->time_frame[0], latest);
+                to_visit.push(predecessor);
             }
         }
     }
 }
-
@@ -3,35 +3,79 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 
 #include "NetlistParser.h"
 #include "graph.h"
+#include "resources.h"
+#include "thread_pool.h"
+#include "exclusion.h"
 
 class FDS{
     public:
         Graph *graph;
-        // Might be handled better...
-        std::vector<double> add_sub_prob;
-        std::vector<double> mul_prob;
-        std::vector<double> log_prob;
-        std::vector<double> div_mod_prob;
+        // Distribution graph of every resource class, stored as a [resource x cycle] matrix
+        std::vector<double> type_dist;
+        size_t num_resources;
 
         int64_t latency_requirement;
 
-        FDS(Graph *graph, int64_t latency_requirement);
+        // If/else arms whose operations share units (see exclusion.h). type_dist holds the
+        // demand of the top level; arm_dist holds a [cycle] row of the demand of every other arm
+        // and resource class that has operations, arm_rows its row by arm * num_resources + resource, -1 for none
+        MutualExclusion exclusion;
+        std::vector<double> arm_dist;
+        std::vector<int64_t> arm_rows;
+
+        // Vertices of every resource class sorted by ASAP time, and the widest [asap, alap] window
+        // of the class, so a frame change only visits the class vertices whose windows reach it
+        std::vector<std::vector<Node*>> class_vertices;
+        std::vector<int64_t> class_window;
+
+        // Vertices in topological order, used to evaluate the force cones bottom-up
+        std::vector<Node*> topo_order;
+
+        // Optional pool for evaluating force cones and candidate slots, nullptr runs serially
+        ThreadPool *pool;
+
+        // Work done by the placement steps, reported in the trace: candidate slots scored plus
+        // self-force rows and cone values recomputed, and nodes visited by the cone walks
+        int64_t force_evaluations = 0;
+        int64_t traversal_nodes = 0;
+
+        FDS(Graph *graph, int64_t latency_requirement, ThreadPool *pool = nullptr);
         Graph* run_force_directed_scheduler();
+        Graph* schedule_time_frames();
         void asap_scheduler();
         void alap_scheduler();
+        int64_t critical_path();
+        bool meets_latency_requirement();
         void assign_time_frames();
         void calculate_fds_prob();
         void calculate_type_dist();
+        double* type_distribution(int resource_id);
+        double* arm_distribution(int arm, int resource_id);
+        void add_demand(Node *node, int64_t slot, double probability);
+        void remove_from_distribution(Node *node);
+        void add_to_distribution(Node *node);
+        void set_time_frame(Node *node, int64_t start, int64_t end);
+        void invalidate_overlapping(int resource_id, int64_t start, int64_t end);
         void perform_scheduling();
-        double calculate_self_force(int64_t possible_time, int64_t time_frame[], std::vector<double> fds_prob, std::string op_type, std::string name);
-        double calculate_predecessor_force(Node *node, int64_t possible_time, int64_t time_frame[], std::vector<double> fds_prob, std::string op_type);
-        double calculate_successor_force(Node *node, int64_t possible_time, int64_t time_frame[], std::vector<double> fds_prob, std::string op_type);
-        void traverse_graph(Node *node, int64_t earlier_time, double &total_successor_force, std::string direction);
+        double calculate_predecessor_force(Node *node, int64_t possible_time);
+        double calculate_successor_force(Node *node, int64_t possible_time);
         void update_time_frames(Node *node);
 
+        // Memoized force engine
+        void compute_topological_order();
+        void refresh_self_forces(Node *node);
+        double self_force_after(Node *node, int64_t earlier_time);
+        double self_force_before(Node *node, int64_t later_time);
+        double successor_cone_force(Node *node);
+        double predecessor_cone_force(Node *node);
+        void evaluate_cone(Node *node, bool successors);
+        void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+        void invalidate_node(Node *node);
+
         void print_asap();
         void print_alap();
         void print_time_frames();
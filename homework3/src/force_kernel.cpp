@@ -0,0 +1,104 @@
+#include "force_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FORCE_KERNEL_X86
+#endif
+
+namespace {
+
+typedef void (*SelfForceKernel)(const double*, const double*, int64_t, double*);
+
+void self_forces_scalar(const double* type_prob, const double* fds_prob, int64_t width, double* self_forces) {
+    double expected = 0.0;
+    for (int64_t iter = 0; iter < width; iter++) {
+        expected += type_prob[iter] * fds_prob[iter];
+    }
+    for (int64_t iter = 0; iter < width; iter++) {
+        self_forces[iter] = type_prob[iter] - expected;
+    }
+}
+
+#if defined(FORCE_KERNEL_X86)
+__attribute__((target("sse2")))
+void self_forces_sse2(const double* type_prob, const double* fds_prob, int64_t width, double* self_forces) {
+    __m128d sum = _mm_setzero_pd();
+    int64_t iter = 0;
+    for (; iter + 2 <= width; iter += 2) {
+        sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(type_prob + iter), _mm_loadu_pd(fds_prob + iter)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, sum);
+    double expected = lanes[0] + lanes[1];
+    for (; iter < width; iter++) {
+        expected += type_prob[iter] * fds_prob[iter];
+    }
+
+    __m128d broadcast = _mm_set1_pd(expected);
+    iter = 0;
+    for (; iter + 2 <= width; iter += 2) {
+        _mm_storeu_pd(self_forces + iter, _mm_sub_pd(_mm_loadu_pd(type_prob + iter), broadcast));
+    }
+    for (; iter < width; iter++) {
+        self_forces[iter] = type_prob[iter] - expected;
+    }
+}
+
+__attribute__((target("avx2")))
+void self_forces_avx2(const double* type_prob, const double* fds_prob, int64_t width, double* self_forces) {
+    __m256d sum = _mm256_setzero_pd();
+    int64_t iter = 0;
+    for (; iter + 4 <= width; iter += 4) {
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(type_prob + iter), _mm256_loadu_pd(fds_prob + iter)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sum);
+    double expected = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; iter < width; iter++) {
+        expected += type_prob[iter] * fds_prob[iter];
+    }
+
+    __m256d broadcast = _mm256_set1_pd(expected);
+    iter = 0;
+    for (; iter + 4 <= width; iter += 4) {
+        _mm256_storeu_pd(self_forces + iter, _mm256_sub_pd(_mm256_loadu_pd(type_prob + iter), broadcast));
+    }
+    for (; iter < width; iter++) {
+        self_forces[iter] = type_prob[iter] - expected;
+    }
+}
+#endif
+
+struct KernelChoice {
+    SelfForceKernel kernel;
+    const char* name;
+};
+
+KernelChoice select_kernel() {
+#if defined(FORCE_KERNEL_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {self_forces_avx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {self_forces_sse2, "sse2"};
+    }
+#endif
+    return {self_forces_scalar, "scalar"};
+}
+
+const KernelChoice& kernel_choice() {
+    // Picked once on first use, the CPU does not change underneath us
+    static const KernelChoice choice = select_kernel();
+    return choice;
+}
+
+}
+
+void compute_self_forces(const double* type_prob, const double* fds_prob, int64_t width, double* self_forces) {
+    kernel_choice().kernel(type_prob, fds_prob, width, self_forces);
+}
+
+const char* self_force_kernel_name() {
+    return kernel_choice().name;
+}
@@ -0,0 +1,15 @@
+#ifndef FORCE_KERNEL_H
+#define FORCE_KERNEL_H
+
+#include <cstdint>
+
+// Self force of scheduling an operation at slot i of its time frame:
+//   F(i) = sum_t DG(t) * (delta(i,t) - P(t)) = DG(i) - sum_t DG(t) * P(t)
+// type_prob and fds_prob point at the first slot of the frame, width is its length.
+// Writes F for every slot of the frame into self_forces in one pass.
+void compute_self_forces(const double* type_prob, const double* fds_prob, int64_t width, double* self_forces);
+
+// Name of the kernel picked for this CPU ("avx2", "sse2" or "scalar")
+const char* self_force_kernel_name();
+
+#endif
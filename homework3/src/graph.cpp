@@ -3,17 +3,26 @@
 #include <fstream>
 #include <sstream>
 #include <stack>
+#include <algorithm>
+#include <map>
 
 #include "graph.h"
+#include "chaining.h"
+#include "exclusion.h"
+#include "hls_error.h"
+#include "trace.h"
 
-Node::Node(std::string name, std::string type, std::vector<std::string> inputs, std::string output, int64_t datawidth, int64_t latency_requirement, int64_t latency, Operation operation) {
+Node::Node(int id, std::string name, int resource_id, std::vector<std::string> inputs, std::string output, int64_t datawidth, int64_t latency_requirement, int64_t latency, Operation operation) {
+    this->id = id;
     this->name = name;
-    this->type = type;
+    this->type = ResourceRegistry::instance().at(resource_id).name;
+    this->resource_id = resource_id;
     this->inputs = inputs;
     this->output = output;
     this->datawidth = datawidth;
     this->latency = latency;
     this->operation = operation;
+    this->chain_group = -1;
 
     this->asap_time = 1;
     this->alap_time = latency_requirement - latency + 1;
@@ -22,19 +31,18 @@ Node::Node(std::string name, std::string type, std::vector<std::string> inputs,
     this->fds_width = 0;
     this->fds_time = 0;
 
+    this->topo_index = 0;
+    this->successor_cone = 0.0;
+    this->predecessor_cone = 0.0;
+    this->self_forces_valid = false;
+    this->successor_cone_valid = false;
+    this->predecessor_cone_valid = false;
+
     for (int iter = 0; iter < latency_requirement; iter++) {
         fds_prob.push_back(0.0);
     }
 }
 
-void Node::setNext(Node* node) {
-   next.push_back(node);
-}
-
-void Node::setPrev(Node* node){
-    prev.push_back(node);
-}
-
 std::ostream& operator<<(std::ostream& os, const Node& node) {
     if(node.type.empty()){
         os << "Node { name: " << node.name << " }";
@@ -52,58 +60,77 @@ std::ostream& operator<<(std::ostream& os, const Node& node) {
     return os;
 }
 
-Graph::Graph(std::vector<Operation> operations, int64_t latency_requirement){
+Graph::Graph(const OperationGraph& operations, int64_t latency_requirement, double clock_period){
+    TraceSpan span("graph", "build graph");
     this->latency_requirement = latency_requirement;
 
-    std::string type;
-
-    for (const Operation& op : operations) {
-        if(op.resource == "adder/subtractor"){
-            type = "ADD_SUB";
-        }else if(op.resource == "logic/logical"){
-            type = "LOG";
-        }else if(op.resource == "divider/modulo"){
-            type = "DIV_MOD";
-        }else if(op.resource == "multiplier"){
-            type = "MUL";
-        }else if(op.name == "source"){
-            continue;
-        }else if(op.name == "sink"){
-            continue;
-        }else{  
-            std::cout << "No resource like " << op.resource << std::endl;
-            exit(0);
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+
+    std::vector<int> vertex_ids(operations.operations.size(), -1);
+    for (const Operation& op : operations.operations) {
+        int resource_id = registry.id_of_resource(op.resource);
+        if(resource_id < 0){
+            if(op.name == "source" || op.name == "sink"){
+                continue;
+            }
+            throw HlsError("No resource like " + op.resource, HlsErrorKind::invalid_design);
         }
 
-        Node *temp = new Node(op.name, type, op.operands, op.result, op.width, latency_requirement, op.cycles, op);
+        vertex_ids[op.id] = this->vertices.size();
+        Node *temp = new Node(this->vertices.size(), op.name, resource_id, op.operands, op.result, op.width, latency_requirement, op.cycles, op);
         this->vertices.push_back(temp);
     } 
 
-    this->generate_components_and_dependencies(operations);
+    this->generate_components_and_dependencies(operations, vertex_ids);
+    if(clock_period > 0.0){
+        assign_chain_groups(*this, clock_period);
+    }
+    span.arg("vertices", this->vertices.size());
+    span.arg("edges", this->dependencies.num_edges());
 }
 
-void Graph::generate_components_and_dependencies(std::vector<Operation> operations){
-    for (const Operation& op : operations) {
-        for (const auto& vertex : this->vertices) {
-            if(op.name == vertex->name){
-                for(const auto& successor : op.successors){
-                    for (const auto& sub_vertex : this->vertices) {
-                        if(successor == sub_vertex->name){
-                            vertex->setNext(sub_vertex);
-                        }
-                    }    
-                }
-                for(const auto& predecessor : op.predecessors){
-                    for (const auto& sub_vertex : this->vertices) {
-                        if(predecessor == sub_vertex->name){
-                            vertex->setPrev(sub_vertex);
-                        }
-                    }    
-                }
-            }
-            
+Graph::~Graph(){
+    for (const auto& vertex : this->vertices) {
+        delete vertex;
+    }
+}
+
+std::vector<int64_t> Graph::peak_resource_usage() const{
+    size_t num_resources = ResourceRegistry::instance().size();
+    int64_t length = 0;
+    for (const auto& vertex : this->vertices) {
+        length = std::max(length, vertex->fds_time + vertex->latency);
+    }
+
+    // An operation keeps its unit busy for all of its cycles, and operations of
+    // opposite if/else arms busy in the same cycle share one (see exclusion.h)
+    MutualExclusion exclusion(*this);
+    std::vector<std::map<int, int64_t>> usage(num_resources * length);
+    for (const auto& vertex : this->vertices) {
+        for(int64_t cycle = std::max<int64_t>(0, vertex->fds_time); cycle < vertex->fds_time + vertex->latency; cycle++){
+            usage[vertex->resource_id * length + cycle][exclusion.arm_of(vertex)]++;
         }
     }
+    std::vector<int64_t> peaks(num_resources, 0);
+    for (size_t index = 0; index < usage.size(); index++) {
+        peaks[index / length] = std::max(peaks[index / length], exclusion.combine(usage[index]));
+    }
+    return peaks;
+}
+
+void Graph::generate_components_and_dependencies(const OperationGraph& operations, const std::vector<int>& vertex_ids){
+    // Source and sink links are implicit here, so only the data/branch edges carry over
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(operations.edges.size());
+    for (const auto& edge : operations.edges) {
+        edges.push_back({vertex_ids[edge.from], vertex_ids[edge.to]});
+    }
+    this->dependencies = DependencyGraph(this->vertices.size(), edges);
+
+    for (const auto& vertex : this->vertices) {
+        vertex->next = NodeRange<Node>(this->dependencies.successors(vertex->id), this->vertices.data());
+        vertex->prev = NodeRange<Node>(this->dependencies.predecessors(vertex->id), this->vertices.data());
+    }
 }
 
 std::ostream& operator<<(std::ostream& os, const Graph& graph) {
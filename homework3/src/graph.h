@@ -5,19 +5,26 @@
 #include <vector>
 
 #include "NetlistParser.h"
+#include "OpPostProcess.h"
+#include "resources.h"
+#include "dependency_graph.h"
 
 
 // Node structure for each datapath component in the graph
 class Node {
 public:
     // Key attributes for distinguishing between different datapath components
+    int id;     // index into Graph::vertices
     std::string name;
     std::string type;
+    int resource_id;
     std::vector<std::string> inputs;
     std::string output;
     int64_t datawidth;
     int64_t latency;
     Operation operation;
+    // Operations of one chain group may run in the same state as their predecessors in it, -1 for none (see chaining.h)
+    int chain_group;
 
     // Attributes for force scheduling algorithm
     int64_t latency_requirement;
@@ -28,31 +35,53 @@ public:
     std::vector<double> fds_prob;
     int64_t fds_time;
 
-    // Next and previous node arrays to keep track of dependencies between datapath components
-    std::vector<Node*> next;
-    std::vector<Node*> prev;
+    // Memoized force terms (see FDS::refresh_self_forces and FDS::*_cone_force)
+    int64_t topo_index;
+    std::vector<double> self_forces;        // self force of each slot in time_frame
+    std::vector<double> self_force_prefix;  // prefix sums of self_forces
+    double successor_cone;
+    double predecessor_cone;
+    bool self_forces_valid;
+    bool successor_cone_valid;
+    bool predecessor_cone_valid;
+
+    // Next and previous nodes of the datapath component, views into the graph's dependencies
+    NodeRange<Node> next;
+    NodeRange<Node> prev;
 
     // Constructors
-    Node(std::string name, std::string type, std::vector<std::string> inputs, std::string output, int64_t datawidth, int64_t latency_requirement, int64_t latency, Operation operation);
-    // Setters for dependencies
-    void setNext(Node* node);
-    void setPrev(Node* node);
+    Node(int id, std::string name, int resource_id, std::vector<std::string> inputs, std::string output, int64_t datawidth, int64_t latency_requirement, int64_t latency, Operation operation);
     // << overload for print
     friend std::ostream& operator<<(std::ostream& os,  const Node& node);
 };
 
+// Fewest cycles between the starts of a predecessor and its successor; a successor chained
+// to its single-cycle predecessor may start in the same state
+inline int64_t start_distance(const Node* predecessor, const Node* successor) {
+    return predecessor->chain_group >= 0 && predecessor->chain_group == successor->chain_group ? predecessor->latency - 1 : predecessor->latency;
+}
+
 class Graph{
 public:
 
     // Necessary nodes for the graph
     std::vector<Node*> vertices;
 
+    // Fan-in/fan-out of the vertices by Node::id (source and sink are not vertices)
+    DependencyGraph dependencies;
+
     int64_t latency_requirement;
 
-    // Graph constructor (uses input from netlist parser)
-    Graph(std::vector<Operation> operations, int64_t latency_requirement);
-    // Helpers for generating dependency between nodes and connecting with source and sink nodes
-    void generate_components_and_dependencies(std::vector<Operation> operations);
+    // Graph constructor (uses the operation graph built from the netlist); a positive
+    // clock period in ns chains dependent operations whose summed delay fits it
+    Graph(const OperationGraph& operations, int64_t latency_requirement, double clock_period = 0.0);
+    Graph(const Graph&) = delete;
+    Graph& operator=(const Graph&) = delete;
+    ~Graph();
+    // Helper for generating dependencies between nodes, vertex_ids maps an operation id to its vertex
+    void generate_components_and_dependencies(const OperationGraph& operations, const std::vector<int>& vertex_ids);
+    // Largest number of operations of each resource class busy in the same cycle of the schedule (by resource id)
+    std::vector<int64_t> peak_resource_usage() const;
     // << overload for print
     friend std::ostream& operator<<(std::ostream& os,  const Graph& graph);
 
@@ -0,0 +1,34 @@
+#ifndef HLS_ERROR_H
+#define HLS_ERROR_H
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+// What made a compilation fail, so callers can tell a latency the scheduler cannot meet from
+// a design or options it cannot schedule at all
+enum class HlsErrorKind {
+    failure,            // malformed netlist, unreadable file, bad option, ...
+    unschedulable,      // the scheduler cannot meet the latency
+    invalid_design,     // dependency cycle or an operation no resource class implements
+    invalid_resources   // the resource limits or initiation interval leave an operation no unit
+};
+
+// Failure of one compilation: a bad netlist, a latency that cannot be met, ...
+// A single run prints the message and exits with exit_code; a batch run reports it
+// for the failing job and carries on with the others.
+class HlsError : public std::runtime_error {
+public:
+    explicit HlsError(const std::string& message, HlsErrorKind kind = HlsErrorKind::failure)
+        : std::runtime_error(message), error_kind(kind) {}
+
+    HlsErrorKind kind() const { return error_kind; }
+
+    // 0 for an unschedulable latency, which is reported on stdout like a regular result
+    int exit_code() const { return error_kind == HlsErrorKind::unschedulable ? 0 : EXIT_FAILURE; }
+
+private:
+    HlsErrorKind error_kind;
+};
+
+#endif
@@ -0,0 +1,167 @@
+#include <filesystem>
+
+#include "hlsyn.h"
+#include "DagLoader.h"
+#include "NetlistParser.h"
+#include "OpPostProcess.h"
+#include "IrOptimizer.h"
+#include "VerilogGenerator.h"
+#include "fds.h"
+#include "list_scheduler.h"
+#include "modulo_scheduler.h"
+#include "resource_library.h"
+#include "hls_error.h"
+
+namespace hlsyn {
+
+namespace {
+
+Status make_status(StatusCode code, const std::string& message) {
+    Status status;
+    status.code = code;
+    status.message = message;
+    return status;
+}
+
+// Runs one step of the compiler, turning the HlsError it throws into a status; failure is the
+// code of an error that has no more specific kind
+template <typename Step>
+Status run_step(StatusCode failure, Step step) {
+    try {
+        step();
+    } catch (const HlsError& error) {
+        return make_status(status_code(error, failure), error.what());
+    } catch (const std::exception& error) {
+        return make_status(StatusCode::internal_error, error.what());
+    }
+    return Status();
+}
+
+}
+
+StatusCode status_code(const HlsError& error, StatusCode failure) {
+    switch (error.kind()) {
+        case HlsErrorKind::unschedulable: return StatusCode::unschedulable;
+        case HlsErrorKind::invalid_design: return StatusCode::parse_error;
+        case HlsErrorKind::invalid_resources: return StatusCode::invalid_argument;
+        case HlsErrorKind::failure: break;
+    }
+    return failure;
+}
+
+Schedule::Schedule() = default;
+Schedule::~Schedule() = default;
+Schedule::Schedule(Schedule&&) = default;
+Schedule& Schedule::operator=(Schedule&&) = default;
+
+Status load_resource_library(const std::string& path) {
+    if (!std::filesystem::exists(path)) {
+        return make_status(StatusCode::io_error, "Error: Resource library '" + path + "' does not exist.");
+    }
+    return run_step(StatusCode::parse_error, [&path]() {
+        ResourceLibrary::instance().load(path);
+    });
+}
+
+Status parse_netlist(std::string_view source, Design& design) {
+    return run_step(StatusCode::parse_error, [&source, &design]() {
+        NetlistParser parser("");
+        parser.parseSource(source);
+        Design parsed;
+        parsed.optimization = optimizeOperations(parser);
+        parsed.graph = OpPostProcess("netlist", parser);
+        parsed.components = parser.getComponents();
+        parsed.warnings = parser.getWarnings();
+        design = std::move(parsed);
+    });
+}
+
+Status load_netlist(const std::string& path, Design& design, const std::string& cache_dir) {
+    if (!std::filesystem::exists(path)) {
+        return make_status(StatusCode::io_error, "Error: Netlist file '" + path + "' does not exist.");
+    }
+    return run_step(StatusCode::parse_error, [&path, &design, &cache_dir]() {
+        design = compileDesign(path, cache_dir);
+    });
+}
+
+Status load_dag(const std::string& path, Design& design) {
+    if (!std::filesystem::exists(path)) {
+        return make_status(StatusCode::io_error, "Error: DAG file '" + path + "' does not exist.");
+    }
+    return run_step(StatusCode::parse_error, [&path, &design]() {
+        Design loaded;
+        loaded.graph = loadDag(path);
+        design = std::move(loaded);
+    });
+}
+
+Status schedule(const Design& design, const ScheduleOptions& options, Schedule& result) {
+    if (options.latency < 1) {
+        return make_status(StatusCode::invalid_argument, "Error: Latency must be at least 1, found " + std::to_string(options.latency));
+    }
+    if (options.scheduler != "fds" && options.scheduler != "list") {
+        return make_status(StatusCode::invalid_argument, "Error: Unknown scheduler '" + options.scheduler + "'");
+    }
+    if (options.clock_period < 0.0) {
+        return make_status(StatusCode::invalid_argument, "Error: Clock period must not be negative");
+    }
+    if (options.initiation_interval < 0) {
+        return make_status(StatusCode::invalid_argument, "Error: Initiation interval must not be negative");
+    }
+    if (options.initiation_interval > 0 && options.clock_period > 0.0) {
+        return make_status(StatusCode::invalid_argument, "Error: Chained operations cannot be pipelined, give either a clock period or an initiation interval");
+    }
+    if (design.graph.operations.size() < 2) {
+        return make_status(StatusCode::invalid_argument, "Error: The design has not been parsed");
+    }
+
+    std::vector<int64_t> resource_limits;
+    Status status = run_step(StatusCode::invalid_argument, [&options, &resource_limits]() {
+        resource_limits = ListScheduler::parse_resource_limits(options.resources);
+    });
+    if (!status.ok()) {
+        return status;
+    }
+
+    std::unique_ptr<Graph> graph;
+    status = run_step(StatusCode::internal_error, [&design, &options, &resource_limits, &graph]() {
+        graph = std::make_unique<Graph>(design.graph, options.latency, options.clock_period);
+        if (options.initiation_interval > 0) {
+            ModuloScheduler modulo_scheduler(graph.get(), options.latency, options.initiation_interval, resource_limits);
+            modulo_scheduler.run_modulo_scheduler();
+        } else if (options.scheduler == "list") {
+            ListScheduler list_scheduler(graph.get(), options.latency, resource_limits);
+            list_scheduler.run_list_scheduler();
+        } else {
+            FDS fds(graph.get(), options.latency, options.pool);
+            fds.run_force_directed_scheduler();
+        }
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    result.design = &design;
+    result.scheduled = std::move(graph);
+    result.initiation_interval = options.initiation_interval;
+    return status;
+}
+
+Status emit_verilog(const Schedule& schedule, std::ostream& sink, const std::string& module_name) {
+    if (schedule.scheduled == nullptr) {
+        return make_status(StatusCode::invalid_argument, "Error: The design has not been scheduled");
+    }
+    if (schedule.design->components.empty()) {
+        return make_status(StatusCode::invalid_argument, "Error: The design has no components (DAG input), it cannot be emitted as Verilog");
+    }
+    Status status = run_step(StatusCode::internal_error, [&schedule, &sink, &module_name]() {
+        VerilogGenerator verilog_generator(schedule.design->components, schedule.design->graph.operations, schedule.scheduled.get(), schedule.initiation_interval);
+        verilog_generator.generateVerilog(sink, module_name);
+    });
+    if (status.ok() && !sink) {
+        return make_status(StatusCode::io_error, "Error: Writing the Verilog module failed");
+    }
+    return status;
+}
+
+}
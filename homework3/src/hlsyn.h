@@ -0,0 +1,98 @@
+#ifndef HLSYN_H
+#define HLSYN_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "IrCache.h"
+#include "graph.h"
+#include "hls_error.h"
+#include "thread_pool.h"
+
+// Embeddable API of libhlsyn. Every call reports failures through the returned Status instead
+// of printing and exiting, so a single process can compile any number of designs, also from
+// several threads as long as each design and schedule is used by one thread at a time.
+// The resource classes and the resource library are process-wide and unguarded: load them
+// before the threads start, never while another thread parses or schedules.
+namespace hlsyn {
+
+enum class StatusCode {
+    ok,
+    invalid_argument,   // latency, scheduler or resource limits out of range, or too few units for the design
+    io_error,           // unreadable input or failed write to the sink
+    parse_error,        // malformed netlist or DAG, or a dependency graph no scheduler can order
+    unschedulable,      // the scheduler cannot meet the latency
+    internal_error      // anything else, e.g. out of memory
+};
+
+struct Status {
+    StatusCode code = StatusCode::ok;
+    std::string message;
+
+    bool ok() const { return code == StatusCode::ok; }
+};
+
+// Status code of an HlsError thrown by the compiler (see hls_error.h); failure for an error of
+// no more specific kind
+StatusCode status_code(const HlsError& error, StatusCode failure);
+
+// Components and dependency graph of a design are held in a CompiledDesign (see IrCache.h)
+using Design = CompiledDesign;
+
+struct ScheduleOptions {
+    int64_t latency = 0;
+    std::string scheduler = "fds";   // "fds" or "list"
+    std::string resources;           // units per class for the list and modulo schedulers, e.g. "mul=2,add_sub=3"
+    ThreadPool* pool = nullptr;      // FDS evaluates its candidates on the pool when given
+    double clock_period = 0.0;       // ns; when positive, dependent operations whose delays fit share a state
+    int64_t initiation_interval = 0; // when positive, modulo schedules with the units of resources and emits a
+                                     // pipeline taking an input set every that many cycles (scheduler is ignored)
+};
+
+// Scheduled datapath of a design; it refers to the design, which has to outlive it
+class Schedule {
+public:
+    Schedule();
+    ~Schedule();
+    Schedule(Schedule&&);
+    Schedule& operator=(Schedule&&);
+
+    // nullptr until schedule() succeeded
+    const Graph* graph() const { return scheduled.get(); }
+
+private:
+    friend Status schedule(const Design& design, const ScheduleOptions& options, Schedule& result);
+    friend Status emit_verilog(const Schedule& schedule, std::ostream& sink, const std::string& module_name);
+
+    const Design* design = nullptr;
+    std::unique_ptr<Graph> scheduled;
+    int64_t initiation_interval = 0;
+};
+
+// Replaces the process-wide cycles and delays per operation type and width (see
+// resource_library.h); designs parsed afterwards use them. Not thread safe, see above.
+Status load_resource_library(const std::string& path);
+
+// Parses netlist text, optimizes its operations and builds its dependency graph; problems the
+// parser worked around are listed in design.warnings
+Status parse_netlist(std::string_view source, Design& design);
+
+// Same for a netlist file, through the .hlsir cache in cache_dir when one is given (see
+// defaultCacheDirectory in IrCache.h)
+Status load_netlist(const std::string& path, Design& design, const std::string& cache_dir = "");
+
+// Reads a DAG in the intermediate text format; it has no components, so it can be scheduled
+// but not emitted as Verilog
+Status load_dag(const std::string& path, Design& design);
+
+Status schedule(const Design& design, const ScheduleOptions& options, Schedule& result);
+
+// Writes the FSM (or pipeline) of the scheduled design as a Verilog module into sink
+Status emit_verilog(const Schedule& schedule, std::ostream& sink, const std::string& module_name = "HLSM");
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <queue>
+#include <tuple>
+#include <algorithm>
+#include <unordered_map>
+
+#include "list_scheduler.h"
+#include "hls_error.h"
+#include "trace.h"
+#include "number_parsing.h"
+
+ListScheduler::ListScheduler(Graph* graph, int64_t latency_requirement, std::vector<int64_t> resource_limits){
+    this->graph = graph;
+    this->latency_requirement = latency_requirement;
+    this->resource_limits = resource_limits;
+    this->critical_path = 0;
+}
+
+Graph* ListScheduler::run_list_scheduler(){
+    TraceSpan span("schedule", "list schedule");
+    this->compute_priorities();
+    int64_t schedule_length = this->perform_scheduling();
+
+#if defined(ENABLE_LOGGING)
+    std::cout << "List schedule length: " << schedule_length << " (critical path " << this->critical_path << ")" << std::endl;
+    this->print_fds_times();
+#endif
+
+    if(schedule_length > this->latency_requirement){
+        throw HlsError("Couldn't meet the latency requirement of " + std::to_string(this->latency_requirement) + " cycles with the given resources (needs " + std::to_string(schedule_length) + ")! Increase the latency or the resources, exiting ...", HlsErrorKind::unschedulable);
+    }
+    return this->graph;
+}
+
+void ListScheduler::compute_priorities(){
+    std::unordered_map<Node*, size_t> pending;
+    std::queue<Node*> ready;
+
+    this->topo_order.clear();
+    for (const auto& vertex : this->graph->vertices) {
+        pending[vertex] = vertex->prev.size();
+        if(vertex->prev.empty()){
+            ready.push(vertex);
+        }
+    }
+    while(!ready.empty()){
+        Node *vertex = ready.front();
+        ready.pop();
+        vertex->topo_index = this->topo_order.size();
+        this->topo_order.push_back(vertex);
+        for (const auto& successor : vertex->next) {
+            if(--pending[successor] == 0){
+                ready.push(successor);
+            }
+        }
+    }
+    if(this->topo_order.size() != this->graph->vertices.size()){
+        throw HlsError("Dependency graph has a cycle, cannot schedule! Exiting ...", HlsErrorKind::invalid_design);
+    }
+
+    // ASAP over the topological order, 1-based like FDS
+    this->critical_path = 0;
+    for (const auto& vertex : this->topo_order) {
+        vertex->asap_time = 1;
+        for (const auto& predecessor : vertex->prev) {
+            vertex->asap_time = std::max(vertex->asap_time, predecessor->asap_time + start_distance(predecessor, vertex));
+        }
+        this->critical_path = std::max(this->critical_path, vertex->asap_time + vertex->latency - 1);
+    }
+
+    // ALAP against the critical path, so the priorities do not depend on the latency bound
+    for (auto it = this->topo_order.rbegin(); it != this->topo_order.rend(); ++it) {
+        Node *vertex = *it;
+        vertex->alap_time = this->critical_path - vertex->latency + 1;
+        for (const auto& successor : vertex->next) {
+            vertex->alap_time = std::min(vertex->alap_time, successor->alap_time - start_distance(vertex, successor));
+        }
+    }
+}
+
+int64_t ListScheduler::perform_scheduling(){
+    typedef std::tuple<int64_t, int64_t, int64_t> Priority;  // ALAP time, mobility, topological index
+    typedef std::pair<Priority, Node*> ReadyEntry;
+    typedef std::pair<int64_t, Node*> TimedEntry;
+
+    size_t num_resources = this->resource_limits.size();
+    std::vector<std::priority_queue<ReadyEntry, std::vector<ReadyEntry>, std::greater<ReadyEntry>>> ready(num_resources);
+    std::priority_queue<TimedEntry, std::vector<TimedEntry>, std::greater<TimedEntry>> released;   // by earliest start
+    std::priority_queue<TimedEntry, std::vector<TimedEntry>, std::greater<TimedEntry>> running;    // by finish cycle
+    std::vector<int64_t> in_use(num_resources, 0);
+    std::unordered_map<Node*, size_t> pending;
+    std::unordered_map<Node*, int64_t> earliest;
+
+    for (const auto& vertex : this->topo_order) {
+        pending[vertex] = vertex->prev.size();
+        earliest[vertex] = 0;
+        if(vertex->prev.empty()){
+            released.push({0, vertex});
+        }
+    }
+
+    int64_t cycle = 0;
+    int64_t schedule_length = 0;
+    size_t scheduled = 0;
+    while(scheduled < this->topo_order.size()){
+        while(!running.empty() && running.top().first <= cycle){
+            in_use[running.top().second->resource_id]--;
+            running.pop();
+        }
+        while(!released.empty() && released.top().first <= cycle){
+            Node *vertex = released.top().second;
+            released.pop();
+            Priority priority(vertex->alap_time, vertex->alap_time - vertex->asap_time, vertex->topo_index);
+            ready[vertex->resource_id].push({priority, vertex});
+        }
+
+        for(size_t resource_id = 0; resource_id < num_resources; resource_id++){
+            while(!ready[resource_id].empty() && in_use[resource_id] < this->resource_limits[resource_id]){
+                Node *vertex = ready[resource_id].top().second;
+                ready[resource_id].pop();
+
+                vertex->fds_time = cycle;
+                in_use[resource_id]++;
+                running.push({cycle + vertex->latency, vertex});
+                schedule_length = std::max(schedule_length, cycle + vertex->latency);
+                scheduled++;
+
+                for (const auto& successor : vertex->next) {
+                    earliest[successor] = std::max(earliest[successor], cycle + start_distance(vertex, successor));
+                    if(--pending[successor] == 0){
+                        released.push({earliest[successor], successor});
+                    }
+                }
+            }
+        }
+
+        // Operations chained to one placed in this cycle can still start in it
+        if(!released.empty() && released.top().first <= cycle){
+            continue;
+        }
+
+        // Skip idle cycles: nothing changes before the next unit frees up or the next op is released
+        int64_t next_cycle = INT64_MAX;
+        if(!running.empty()){
+            next_cycle = std::min(next_cycle, running.top().first);
+        }
+        if(!released.empty()){
+            next_cycle = std::min(next_cycle, released.top().first);
+        }
+        if(next_cycle == INT64_MAX){
+            break;
+        }
+        cycle = std::max(cycle + 1, next_cycle);
+    }
+
+    if(scheduled < this->topo_order.size()){
+        throw HlsError("A resource class has no units available, cannot schedule! Exiting ...", HlsErrorKind::invalid_resources);
+    }
+    return schedule_length;
+}
+
+std::vector<int64_t> ListScheduler::parse_resource_limits(const std::string& spec){
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+    std::vector<int64_t> limits(registry.size(), 1);
+
+    std::istringstream stream(spec);
+    std::string entry;
+    while (getline(stream, entry, ',')) {
+        size_t eqPos = entry.find('=');
+        std::string name = entry.substr(0, eqPos);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::toupper(c); });
+        int resource_id = registry.id_of_name(name);
+        if (eqPos == std::string::npos || resource_id < 0) {
+            throw HlsError("Error: Invalid resource limit '" + entry + "'");
+        }
+        int64_t limit = 0;
+        if (!parse_integer(std::string_view(entry).substr(eqPos + 1), limit)) {
+            throw HlsError("Error: Invalid resource limit '" + entry + "'");
+        }
+        if (limit < 1) {
+            throw HlsError("Error: Resource limit for " + name + " must be at least 1");
+        }
+        limits[resource_id] = limit;
+    }
+    return limits;
+}
+
+void ListScheduler::print_fds_times(){
+    std::cout << "Scheduled times:" << std::endl;
+    for (const auto& vertex : this->graph->vertices) {
+        std::cout << vertex->name << ":" << vertex->fds_time << std::endl;
+    }
+    std::cout << "\n";
+}
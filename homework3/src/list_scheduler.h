@@ -0,0 +1,36 @@
+#ifndef LIST_SCHEDULER_H
+#define LIST_SCHEDULER_H
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "resources.h"
+
+// Resource-constrained list scheduler. Operations are started cycle by cycle
+// in priority order (smallest ALAP time first, then smallest mobility) as long
+// as their resource class has a free unit. Fills Node::fds_time with the same
+// 0-based start cycles that FDS produces, so the Verilog generator is shared.
+class ListScheduler{
+    public:
+        Graph *graph;
+        int64_t latency_requirement;
+        // Number of units per resource class, indexed by resource id
+        std::vector<int64_t> resource_limits;
+
+        ListScheduler(Graph *graph, int64_t latency_requirement, std::vector<int64_t> resource_limits);
+        Graph* run_list_scheduler();
+        void compute_priorities();
+        int64_t perform_scheduling();
+
+        // Parses "mul=2,add_sub=3,..." (class names are case insensitive), unlisted classes get 1 unit
+        static std::vector<int64_t> parse_resource_limits(const std::string& spec);
+
+        void print_fds_times();
+
+    private:
+        std::vector<Node*> topo_order;
+        int64_t critical_path;
+};
+
+#endif
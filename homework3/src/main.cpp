@@ -1,74 +1,288 @@
 #include <iostream>
 #include <filesystem> // C++17 header for file path manipulations
 #include <fstream>
+#include <chrono>
+#include <memory>
 
 #include "OpPostProcess.h" 
 #include "NetlistParser.h"
+#include "IrCache.h"
+#include "DagLoader.h"
+#include "batch.h"
+#include "server.h"
+#include "trace.h"
+#include "hls_error.h"
 #include "VerilogGenerator.h"
 #include "graph.h"
 #include "fds.h"
+#include "list_scheduler.h"
+#include "modulo_scheduler.h"
+#include "thread_pool.h"
+#include "sweep.h"
+#include "resource_library.h"
+#include "number_parsing.h"
 
 namespace fs = std::filesystem;
 
-int main(int argc, char** argv) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <cFile> <latency> <verilogFile>\n";
+// A malformed number fails the run like any other bad option
+int64_t integer_argument(const std::string& name, const std::string& text, int64_t minimum = INT64_MIN) {
+    int64_t value = 0;
+    if (!parse_integer(text, value)) {
+        throw HlsError("Error: " + name + " must be an integer, found '" + text + "'");
+    }
+    if (value < minimum) {
+        throw HlsError("Error: " + name + " must be at least " + std::to_string(minimum) + ", found '" + text + "'");
+    }
+    return value;
+}
+
+double number_argument(const std::string& name, const std::string& text) {
+    double value = 0.0;
+    if (!parse_double(text, value)) {
+        throw HlsError("Error: " + name + " must be a number, found '" + text + "'");
+    }
+    return value;
+}
+
+int run(int argc, char** argv, std::string& tracePath) {
+    int64_t threads = 1;
+    std::string scheduler = "fds";
+    std::string resourceLimits;
+    std::string sweepRange;
+    bool autoLatency = false;
+    bool useCache = true;
+    std::string cacheDirectory = defaultCacheDirectory();
+    bool dagInput = false;
+    std::string batchManifest;
+    int64_t jobs = 0;
+    std::string serveSocket;
+    std::string connectSocket;
+    int64_t cacheSize = 64;
+    double clockPeriod = 0.0;
+    int64_t initiationInterval = 0;
+    std::string libraryOutput;
+    std::vector<std::string> arguments;
+    for (int iter = 1; iter < argc; iter++) {
+        std::string argument = argv[iter];
+        if (argument == "--threads" && iter + 1 < argc) {
+            threads = integer_argument(argument, argv[++iter]);
+        } else if (argument == "--scheduler" && iter + 1 < argc) {
+            scheduler = argv[++iter];
+        } else if (argument == "--resources" && iter + 1 < argc) {
+            resourceLimits = argv[++iter];
+        } else if (argument == "--sweep" && iter + 1 < argc) {
+            sweepRange = argv[++iter];
+        } else if (argument == "--auto-latency") {
+            autoLatency = true;
+        } else if (argument == "--batch" && iter + 1 < argc) {
+            batchManifest = argv[++iter];
+        } else if ((argument == "-j" || argument == "--jobs") && iter + 1 < argc) {
+            jobs = integer_argument(argument, argv[++iter]);
+        } else if (argument == "--serve" && iter + 1 < argc) {
+            serveSocket = argv[++iter];
+        } else if (argument == "--connect" && iter + 1 < argc) {
+            connectSocket = argv[++iter];
+        } else if (argument == "--cache-size" && iter + 1 < argc) {
+            cacheSize = integer_argument(argument, argv[++iter]);
+        } else if (argument == "--clock-period" && iter + 1 < argc) {
+            clockPeriod = number_argument(argument, argv[++iter]);
+            if (clockPeriod <= 0.0) {
+                std::cerr << "Error: Clock period must be positive, found '" << argv[iter] << "'\n";
+                return 1;
+            }
+        } else if (argument == "--ii" && iter + 1 < argc) {
+            initiationInterval = integer_argument(argument, argv[++iter]);
+            if (initiationInterval < 1) {
+                std::cerr << "Error: Initiation interval must be at least 1, found '" << argv[iter] << "'\n";
+                return 1;
+            }
+        } else if (argument == "--library" && iter + 1 < argc) {
+            // Loaded before anything is parsed, the cycles of every operation come from it
+            ResourceLibrary::instance().load(argv[++iter]);
+        } else if (argument == "--write-library" && iter + 1 < argc) {
+            libraryOutput = argv[++iter];
+        } else if (argument == "--trace" && iter + 1 < argc) {
+            tracePath = argv[++iter];
+            start_trace();
+        } else if (argument == "--dag") {
+            dagInput = true;
+        } else if (argument == "--cache-dir" && iter + 1 < argc) {
+            cacheDirectory = argv[++iter];
+        } else if (argument == "--no-cache") {
+            useCache = false;
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+
+    if (!useCache) {
+        cacheDirectory.clear();
+    }
+
+    if (!libraryOutput.empty()) {
+        std::ofstream library(libraryOutput);
+        ResourceLibrary::instance().write(library);
+        if (!library) {
+            std::cerr << "Error: Unable to write resource library '" << libraryOutput << "'\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!batchManifest.empty()) {
+        if (!arguments.empty() || jobs < 0 || !sweepRange.empty() || autoLatency || dagInput || clockPeriod > 0.0 || initiationInterval > 0 || (scheduler != "fds" && scheduler != "list")) {
+            std::cerr << "Usage: " << argv[0] << " [--scheduler fds|list] [--resources ...] [--cache-dir <dir>|--no-cache] --batch <manifest> [-j N]\n";
+            return 1;
+        }
+        // Jobs run in parallel with each other, every FDS run stays single-threaded
+        size_t batch_threads = jobs > 0 ? jobs : std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int64_t> resource_limits = ListScheduler::parse_resource_limits(resourceLimits);
+        std::vector<BatchJob> batch = read_batch_manifest(batchManifest);
+        auto start = std::chrono::steady_clock::now();
+        ThreadPool batch_pool(batch_threads);
+        std::vector<BatchResult> results = run_batch(batch, scheduler, resource_limits, cacheDirectory, batch_pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return print_batch_report(batch, results, seconds, std::cout) == 0 ? 0 : 3;
+    }
+
+    if (!serveSocket.empty()) {
+        if (!arguments.empty() || jobs < 0 || cacheSize < 1 || clockPeriod > 0.0 || initiationInterval > 0) {
+            std::cerr << "Usage: " << argv[0] << " --serve <socket> [-j N] [--cache-size N]\n";
+            return 1;
+        }
+        ServerOptions options;
+        options.socket_path = serveSocket;
+        options.workers = jobs > 0 ? jobs : std::max(1u, std::thread::hardware_concurrency());
+        options.cache_designs = cacheSize;
+        return run_compile_server(options);
+    }
+
+    bool sweep = !sweepRange.empty();
+    // A DAG input is only scheduled; the schedule goes to stdout instead of a Verilog file
+    size_t expectedArguments = sweep ? 1 : (autoLatency ? 2 : 3) - (dagInput ? 1 : 0);
+    if (arguments.size() != expectedArguments || threads < 1 || (scheduler != "fds" && scheduler != "list") || (sweep && (scheduler != "fds" || autoLatency)) ||
+        (!connectSocket.empty() && (sweep || autoLatency || dagInput || clockPeriod > 0.0 || initiationInterval > 0)) ||
+        (initiationInterval > 0 && (sweep || autoLatency || clockPeriod > 0.0 || scheduler != "fds"))) {
+        std::cerr << "Usage: " << argv[0] << " [--threads N] [--scheduler fds|list] [--resources mul=2,add_sub=3,...] <cFile> <latency> <verilogFile>\n";
+        std::cerr << "       " << argv[0] << " [--threads N] [--scheduler fds|list] [--resources ...] --auto-latency <cFile> <verilogFile>\n";
+        std::cerr << "       " << argv[0] << " [--threads N] --sweep <minLatency>:<maxLatency> <cFile>\n";
+        std::cerr << "       " << argv[0] << " --ii <N> [--resources ...] [--dag] <cFile> <latency> <verilogFile>\n";
+        std::cerr << "       " << argv[0] << " [--threads N] [--scheduler fds|list] [--resources ...] --dag <dagFile> <latency>|--auto-latency <dagFile>\n";
+        std::cerr << "       " << argv[0] << " [--scheduler fds|list] [--resources ...] --batch <manifest> [-j N]\n";
+        std::cerr << "       " << argv[0] << " --serve <socket> [-j N] [--cache-size N]\n";
+        std::cerr << "       " << argv[0] << " [--scheduler fds|list] [--resources ...] --connect <socket> <cFile> <latency> <verilogFile>\n";
+        std::cerr << "       --trace <out.json> records a Chrome trace of the run in any mode\n";
+        std::cerr << "       " << argv[0] << " [--library <file>] --write-library <file>\n";
+        std::cerr << "       --library <file> reads cycles and delays per operation type and width, in any mode\n";
+        std::cerr << "       --clock-period <ns> chains dependent operations into one state while their summed delay fits (not with --batch/--serve/--connect)\n";
+        std::cerr << "       --dag also combines with --sweep\n";
+        std::cerr << "       --cache-dir <dir> keeps the parsed design of <cFile> in <dir> (default ~/.cache/hlsyn), --no-cache parses it every run\n";
         return 1;
     }
-    std::string cFilePath = argv[1];
+    std::string cFilePath = arguments[0];
     if (!std::filesystem::exists(cFilePath)) {
-        std::cerr << "Error: Netlist file '" << cFilePath << "' does not exist.\n";
+        std::cerr << "Error: " << (dagInput ? "DAG" : "Netlist") << " file '" << cFilePath << "' does not exist.\n";
         return 2; 
     }
 
-    int64_t latency_requirement = std::stoi(argv[2]);
-    std::string moduleName = fs::path(cFilePath).stem().string();
-    std::string outputFilePath = argv[3];
+    if (!connectSocket.empty()) {
+        return run_compile_client(connectSocket, cFilePath, integer_argument("Latency", arguments[1], 0), arguments[2], scheduler, resourceLimits);
+    }
 
-    NetlistParser parser(cFilePath);
-    //parser.modifyModuleName(moduleName);
-    parser.parse();
+    int64_t min_latency = 0;
+    int64_t max_latency = 0;
+    if (sweep) {
+        size_t colonPos = sweepRange.find(':');
+        if (colonPos == std::string::npos) {
+            std::cerr << "Error: Sweep range must look like <minLatency>:<maxLatency>, found '" << sweepRange << "'\n";
+            return 1;
+        }
+        if (!parse_integer(std::string_view(sweepRange).substr(0, colonPos), min_latency) ||
+            !parse_integer(std::string_view(sweepRange).substr(colonPos + 1), max_latency) || min_latency < 1 || max_latency < min_latency) {
+            std::cerr << "Error: Invalid sweep range '" << sweepRange << "'\n";
+            return 1;
+        }
+    }
 
-    // Now, generate the Graphviz file to visualize the operation graph
-    // Construct the .dot file name based on moduleName
+    int64_t latency_requirement = (sweep || autoLatency) ? max_latency : integer_argument("Latency", arguments[1], 0);
+    std::string outputFilePath = (sweep || dagInput) ? "" : arguments.back();
+    std::vector<int64_t> resource_limits = ListScheduler::parse_resource_limits(resourceLimits);
 
-    // Execute the command using std::system
-#if defined(ENABLE_LOGGING)  
-    std::cout << "GetComponents" << std::endl;
-    for (int i = 0; i < parser.getComponents().size(); ++i) {
-        std::cout << parser.getComponents()[i].name << ":" << parser.getComponents()[i].type << std::endl;
+    // The post-processed design is cached in cacheDirectory and reused while the source is unchanged
+    CompiledDesign design = dagInput ? CompiledDesign{{}, loadDag(cFilePath), {}, {}} : compileDesign(cFilePath, cacheDirectory);
+    for (const auto& warning : design.warnings) {
+        std::cerr << warning << std::endl;
     }
-    std::cout << std::endl;
-    
-    std::cout << "GetOperations" << std::endl;
-    for (int i = 0; i < parser.getOperations().size(); ++i) {
-        std::cout << parser.getOperations()[i].symbol << ":" << parser.getOperations()[i].opType << std::endl;
+    OperationGraph& opGraph = design.graph;
+    const OptimizationReport& optimization = design.optimization;
+    if (optimization.removed() > 0) {
+        std::cout << "Removed " << optimization.removed() << " of " << optimization.operations << " operations before scheduling ("
+                  << optimization.folded << " folded, " << optimization.common << " common, " << optimization.dead << " dead)" << std::endl;
     }
-    std::cout << std::endl;
-    // Now, call the OpPostProcess function passing the module name
-#endif
-
-    OperationGraph opGraph = OpPostProcess(moduleName, parser);   
-    std::vector<Operation> sortedOperations = opGraph.sortOperations(opGraph.nodes);
     
 #if defined(ENABLE_LOGGING)  
-    // Print details of each operation after sorting
-    for (const Operation& op : sortedOperations) {
-        op.printDetails();
-    }          
+    // Print details of each operation with its dependencies
+    opGraph.printDetails();
 #endif
 
-    Graph *graph = new Graph(sortedOperations, latency_requirement);
-    FDS *fds = new FDS(graph, latency_requirement);
-    Graph *scheduled_graph = fds->run_force_directed_scheduler();
+    if (sweep) {
+        // One FDS run per latency, all sharing the parsed design; defaults to every core
+        size_t sweep_threads = threads > 1 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        ThreadPool sweep_pool(sweep_threads);
+        std::vector<SweepPoint> points = run_latency_sweep(opGraph, min_latency, max_latency, sweep_pool, clockPeriod);
+        print_sweep_table(points, std::cout);
+        return 0;
+    }
 
-    VerilogGenerator verilog_generator = VerilogGenerator(parser.getComponents(), parser.getOperations(), graph);
+    if (autoLatency) {
+        LatencySearch search = find_minimum_latency(opGraph, scheduler == "list", resource_limits, clockPeriod);
+        latency_requirement = search.latency;
+        std::cout << "Minimum feasible latency: " << search.latency << " cycles (critical path lower bound: " << search.lower_bound << " cycles)" << std::endl;
+    }
 
-    verilog_generator.generateVerilog(outputFilePath, "HLSM");
+    // Candidate slots and force cones are evaluated on a pool only when asked for
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1) {
+        pool = std::make_unique<ThreadPool>(threads);
+    }
+
+    std::unique_ptr<Graph> graph = std::make_unique<Graph>(opGraph, latency_requirement, clockPeriod);
+    if (initiationInterval > 0) {
+        ModuloScheduler modulo_scheduler(graph.get(), latency_requirement, initiationInterval, resource_limits);
+        modulo_scheduler.run_modulo_scheduler();
+    } else if (scheduler == "list") {
+        ListScheduler list_scheduler(graph.get(), latency_requirement, resource_limits);
+        list_scheduler.run_list_scheduler();
+    } else {
+        FDS fds(graph.get(), latency_requirement, pool.get());
+        fds.run_force_directed_scheduler();
+    }
 
-    delete graph;
-    // delete scheduled_graph;
-    delete fds;
+    if (dagInput) {
+        printSchedule(*graph, std::cout);
+        return 0;
+    }
+
+    VerilogGenerator verilog_generator = VerilogGenerator(design.components, opGraph.operations, graph.get(), initiationInterval);
+
+    verilog_generator.generateVerilog(outputFilePath, "HLSM");
 
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv) {
+    std::string tracePath;
+    int status;
+    try {
+        status = run(argc, argv, tracePath);
+    } catch (const HlsError& error) {
+        (error.exit_code() == 0 ? std::cout : std::cerr) << error.what() << std::endl;
+        status = error.exit_code();
+    }
+    // A failed run is traced up to the failure
+    if (!tracePath.empty() && !write_trace(tracePath)) {
+        std::cerr << "Error: Unable to write trace file '" << tracePath << "'\n";
+        return 1;
+    }
+    return status;
+}
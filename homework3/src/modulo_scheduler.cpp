@@ -0,0 +1,130 @@
+#include <iostream>
+#include <queue>
+#include <tuple>
+#include <algorithm>
+#include <unordered_map>
+
+#include "modulo_scheduler.h"
+#include "list_scheduler.h"
+#include "hls_error.h"
+#include "trace.h"
+
+ModuloScheduler::ModuloScheduler(Graph* graph, int64_t latency_requirement, int64_t initiation_interval, std::vector<int64_t> resource_limits){
+    this->graph = graph;
+    this->latency_requirement = latency_requirement;
+    this->initiation_interval = initiation_interval;
+    this->resource_limits = resource_limits;
+}
+
+Graph* ModuloScheduler::run_modulo_scheduler(){
+    TraceSpan span("schedule", "modulo schedule");
+    span.arg("II", this->initiation_interval);
+    int64_t bound = this->resource_bound();
+    if(this->initiation_interval < bound){
+        throw HlsError("Couldn't start an input set every " + std::to_string(this->initiation_interval) + " cycles with the given resources (needs an initiation interval of " + std::to_string(bound) + ")! Increase the initiation interval or the resources, exiting ...", HlsErrorKind::invalid_resources);
+    }
+
+    // Same priorities as the list scheduler: ASAP and ALAP times against the critical path
+    ListScheduler priorities(this->graph, this->latency_requirement, this->resource_limits);
+    priorities.compute_priorities();
+    int64_t schedule_length = this->perform_scheduling();
+
+#if defined(ENABLE_LOGGING)
+    std::cout << "Modulo schedule length: " << schedule_length << " at II " << this->initiation_interval << std::endl;
+    this->print_fds_times();
+#endif
+
+    if(schedule_length > this->latency_requirement){
+        throw HlsError("Couldn't meet the latency requirement of " + std::to_string(this->latency_requirement) + " cycles at an initiation interval of " + std::to_string(this->initiation_interval) + " (needs " + std::to_string(schedule_length) + ")! Increase the latency, the initiation interval or the resources, exiting ...", HlsErrorKind::unschedulable);
+    }
+    return this->graph;
+}
+
+int64_t ModuloScheduler::resource_bound() const{
+    std::vector<int64_t> busy(this->resource_limits.size(), 0);
+    for (const auto& vertex : this->graph->vertices) {
+        busy[vertex->resource_id] += vertex->latency;
+    }
+    int64_t bound = 1;
+    for(size_t resource_id = 0; resource_id < busy.size(); resource_id++){
+        bound = std::max(bound, (busy[resource_id] + this->resource_limits[resource_id] - 1) / this->resource_limits[resource_id]);
+    }
+    return bound;
+}
+
+bool ModuloScheduler::fits(const Node* node, int64_t start) const{
+    // An operation longer than II keeps every slot busy latency / II times, the first latency % II slots once more
+    const int64_t *slots = this->reservations.data() + node->resource_id * this->initiation_interval;
+    int64_t covered = std::min(node->latency, this->initiation_interval);
+    for(int64_t offset = 0; offset < covered; offset++){
+        int64_t uses = node->latency / this->initiation_interval + (offset < node->latency % this->initiation_interval ? 1 : 0);
+        if(slots[(start + offset) % this->initiation_interval] + uses > this->resource_limits[node->resource_id]){
+            return false;
+        }
+    }
+    return true;
+}
+
+void ModuloScheduler::reserve(const Node* node, int64_t start){
+    int64_t *slots = this->reservations.data() + node->resource_id * this->initiation_interval;
+    for(int64_t cycle = start; cycle < start + node->latency; cycle++){
+        slots[cycle % this->initiation_interval]++;
+    }
+}
+
+int64_t ModuloScheduler::perform_scheduling(){
+    typedef std::tuple<int64_t, int64_t, int64_t> Priority;  // ALAP time, mobility, topological index
+    typedef std::pair<Priority, Node*> ReadyEntry;
+
+    std::priority_queue<ReadyEntry, std::vector<ReadyEntry>, std::greater<ReadyEntry>> ready;
+    std::unordered_map<Node*, size_t> pending;
+    std::unordered_map<Node*, int64_t> earliest;
+    this->reservations.assign(this->resource_limits.size() * this->initiation_interval, 0);
+
+    auto release = [&ready](Node *vertex) {
+        Priority priority(vertex->alap_time, vertex->alap_time - vertex->asap_time, vertex->topo_index);
+        ready.push({priority, vertex});
+    };
+    for (const auto& vertex : this->graph->vertices) {
+        pending[vertex] = vertex->prev.size();
+        earliest[vertex] = 0;
+        if(vertex->prev.empty()){
+            release(vertex);
+        }
+    }
+
+    int64_t schedule_length = 0;
+    while(!ready.empty()){
+        Node *vertex = ready.top().second;
+        ready.pop();
+
+        // Starts II cycles apart use the same slots, so one interval of candidates decides
+        int64_t start = earliest[vertex];
+        int64_t last = start + this->initiation_interval - 1;
+        while(start <= last && !this->fits(vertex, start)){
+            start++;
+        }
+        if(start > last){
+            throw HlsError("Couldn't place " + vertex->name + " at an initiation interval of " + std::to_string(this->initiation_interval) + ", the " + vertex->type + " units are busy in the slots it needs! Increase the initiation interval or the resources, exiting ...", HlsErrorKind::invalid_resources);
+        }
+        this->reserve(vertex, start);
+        vertex->fds_time = start;
+        schedule_length = std::max(schedule_length, start + vertex->latency);
+
+        for (const auto& successor : vertex->next) {
+            earliest[successor] = std::max(earliest[successor], start + start_distance(vertex, successor));
+            if(--pending[successor] == 0){
+                release(successor);
+            }
+        }
+    }
+    return schedule_length;
+}
+
+void ModuloScheduler::print_fds_times(){
+    std::cout << "Scheduled times:" << std::endl;
+    for (const auto& vertex : this->graph->vertices) {
+        std::cout << vertex->name << ":" << vertex->fds_time << " (stage " << vertex->fds_time / this->initiation_interval << ")" << std::endl;
+    }
+    std::cout << "\n";
+}
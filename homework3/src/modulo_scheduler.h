@@ -0,0 +1,39 @@
+#ifndef MODULO_SCHEDULER_H
+#define MODULO_SCHEDULER_H
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "resources.h"
+
+// Modulo scheduler for a pipeline that takes a new input set every initiation_interval
+// cycles. Operations are placed in the list scheduler's priority order (smallest ALAP time,
+// then smallest mobility) at their earliest start where the modulo reservation table of
+// their resource class has a free unit in every slot (cycle mod II) they keep busy, so the
+// input sets in flight together never need more units than given. Fills Node::fds_time
+// like the other schedulers; the pipeline has ceil(schedule length / II) stages.
+class ModuloScheduler{
+    public:
+        Graph *graph;
+        int64_t latency_requirement;
+        int64_t initiation_interval;
+        // Number of units per resource class, indexed by resource id
+        std::vector<int64_t> resource_limits;
+
+        ModuloScheduler(Graph *graph, int64_t latency_requirement, int64_t initiation_interval, std::vector<int64_t> resource_limits);
+        Graph* run_modulo_scheduler();
+        // Smallest initiation interval the units allow: each unit runs the cycles of its share of the class every II cycles
+        int64_t resource_bound() const;
+        int64_t perform_scheduling();
+
+        void print_fds_times();
+
+    private:
+        // Units of each class busy in each slot, stored as a [resource x slot] matrix
+        std::vector<int64_t> reservations;
+        bool fits(const Node *node, int64_t start) const;
+        void reserve(const Node *node, int64_t start);
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include <charconv>
+#include <cmath>
+
+#include "number_parsing.h"
+
+bool parse_integer(std::string_view text, int64_t& value) {
+    const char* last = text.data() + text.size();
+    int64_t parsed = 0;
+    auto [end, error] = std::from_chars(text.data(), last, parsed);
+    if (error != std::errc() || end != last) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parse_double(std::string_view text, double& value) {
+    const char* last = text.data() + text.size();
+    double parsed = 0.0;
+    auto [end, error] = std::from_chars(text.data(), last, parsed);
+    if (error != std::errc() || end != last || !std::isfinite(parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
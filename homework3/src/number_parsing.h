@@ -0,0 +1,12 @@
+#ifndef NUMBER_PARSING_H
+#define NUMBER_PARSING_H
+
+#include <cstdint>
+#include <string_view>
+
+// Parse the whole of text as a decimal number; false (value untouched) on anything else,
+// including leading spaces, trailing characters and values out of range
+bool parse_integer(std::string_view text, int64_t& value);
+bool parse_double(std::string_view text, double& value);
+
+#endif
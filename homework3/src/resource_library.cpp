@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "resource_library.h"
+#include "resources.h"
+#include "hls_error.h"
+
+namespace {
+
+// homework2/src/header.h: latency_values at the bitwidths 1, 2, 8, 16, 32 and 64
+const std::array<int64_t, 6> homework2Widths = {1, 2, 8, 16, 32, 64};
+const std::map<std::string, std::array<double, 6>> homework2Delays = {
+    {"REG", {2.616, 2.644, 2.879, 3.061, 3.602, 3.966}},
+    {"ADD", {2.704, 3.713, 4.924, 5.638, 7.270, 9.566}},
+    {"SUB", {3.024, 3.412, 4.890, 5.569, 7.253, 9.566}},
+    {"MUL", {2.438, 3.651, 7.453, 7.811, 12.395, 15.354}},
+    {"COMP", {3.031, 3.934, 5.949, 6.256, 7.264, 8.416}},
+    {"MUX2x1", {4.083, 4.115, 4.815, 5.623, 8.079, 8.766}},
+    {"SHR", {3.644, 4.007, 5.178, 6.460, 8.819, 11.095}},
+    {"SHL", {3.614, 3.980, 5.152, 6.549, 8.565, 11.220}},
+    {"DIV", {0.619, 2.144, 15.439, 33.093, 86.312, 243.233}},
+    {"MOD", {0.758, 2.149, 16.078, 35.563, 88.142, 250.583}},
+    {"INC", {1.792, 2.218, 3.111, 3.471, 4.347, 6.200}},
+    {"DEC", {1.792, 2.218, 3.108, 3.701, 4.685, 6.503}}
+};
+
+// homework1/DPCL_LAT.txt at the widths 2, 8, 16, 32 and 64
+const std::array<int64_t, 5> homework1Widths = {2, 8, 16, 32, 64};
+const std::map<std::string, std::array<double, 5>> homework1Delays = {
+    {"REG", {4.090, 4.090, 4.090, 4.090, 4.090}},
+    {"ADD", {5.36, 6.38, 6.61, 7.08, 8.02}},
+    {"SUB", {5.361, 6.384, 6.618, 7.086, 8.022}},
+    {"COMP", {5.361, 6.191, 6.252, 6.426, 6.756}},
+    {"DEC", {5.361, 5.91, 6.61, 7.08, 8.02}},
+    {"INC", {5.361, 5.919, 6.620, 7.088, 8.024}},
+    {"MOD", {5.36, 19.86, 38.26, 85.68, 224.42}},
+    {"DIV", {5.361, 18.104, 35.511, 81.609, 220.180}},
+    {"MUL", {5.36, 8.62, 9.05, 12.97, 17.10}},
+    {"MUX2x1", {5.36, 5.36, 5.36, 5.36, 5.36}},
+    {"SHL", {5.36, 5.94, 6.24, 7.06, 7.12}},
+    {"SHR", {5.361, 5.934, 6.241, 7.069, 7.121}}
+};
+
+int class_cycles(const std::string& op_type) {
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+    int resource_id = registry.id_of_op_type(op_type);
+    return resource_id < 0 ? 1 : registry.at(resource_id).cycles;
+}
+
+void libraryError(const std::string& path, int line, const std::string& message) {
+    throw HlsError("Error: " + message + " at line " + std::to_string(line) + " of resource library '" + path + "'");
+}
+
+}
+
+ResourceLibrary::ResourceLibrary() {
+    for (const auto& entry : homework2Delays) {
+        const std::string& op_type = entry.first;
+        auto measured = homework1Delays.find(op_type);
+        std::vector<OperationTiming>& timings = this->timings[op_type];
+        for (size_t index = 0; index < homework2Widths.size(); index++) {
+            double delay = entry.second[index];
+            for (size_t other = 0; measured != homework1Delays.end() && other < homework1Widths.size(); other++) {
+                if (homework1Widths[other] == homework2Widths[index]) {
+                    delay = std::max(delay, measured->second[other]);
+                }
+            }
+            timings.push_back({homework2Widths[index], 0, delay});
+        }
+        double widest = timings.back().delay;
+        for (auto& timing : timings) {
+            timing.cycles = std::max(1, static_cast<int>(std::ceil(class_cycles(op_type) * (timing.delay / widest))));
+        }
+    }
+}
+
+ResourceLibrary& ResourceLibrary::instance() {
+    static ResourceLibrary library;
+    return library;
+}
+
+void ResourceLibrary::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw HlsError("Error: Unable to read resource library '" + path + "'");
+    }
+    std::map<std::string, std::vector<OperationTiming>> loaded;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string op_type;
+        if (!(fields >> op_type)) {
+            continue;
+        }
+        OperationTiming timing;
+        std::string extra;
+        if (!(fields >> timing.width >> timing.cycles >> timing.delay) || (fields >> extra)) {
+            libraryError(path, line_number, "Expected '<opType> <width> <cycles> <delayNs>'");
+        }
+        if (timing.width < 1 || timing.cycles < 1 || timing.delay < 0.0) {
+            libraryError(path, line_number, "Width and cycles must be at least 1 and the delay not negative");
+        }
+        std::vector<OperationTiming>& timings = loaded[op_type];
+        auto position = std::lower_bound(timings.begin(), timings.end(), timing.width, [](const OperationTiming& entry, int64_t width) { return entry.width < width; });
+        if (position != timings.end() && position->width == timing.width) {
+            libraryError(path, line_number, "Duplicate entry for " + op_type + " at width " + std::to_string(timing.width));
+        }
+        timings.insert(position, timing);
+    }
+    this->timings = std::move(loaded);
+}
+
+void ResourceLibrary::write(std::ostream& out) const {
+    out << "# <opType> <width> <cycles> <delayNs>\n";
+    out << "# An operation uses the entry of the smallest width that holds it\n";
+    for (const auto& entry : this->timings) {
+        for (const auto& timing : entry.second) {
+            out << std::left << std::setw(8) << entry.first << std::right << std::setw(4) << timing.width << std::setw(4) << timing.cycles
+                << std::fixed << std::setprecision(3) << std::setw(10) << timing.delay << "\n";
+        }
+    }
+}
+
+const OperationTiming* ResourceLibrary::find(const std::string& op_type, int64_t width) const {
+    auto entry = this->timings.find(op_type);
+    if (entry == this->timings.end() || entry->second.empty()) {
+        return nullptr;
+    }
+    const std::vector<OperationTiming>& timings = entry->second;
+    auto position = std::lower_bound(timings.begin(), timings.end(), width, [](const OperationTiming& timing, int64_t bound) { return timing.width < bound; });
+    return position == timings.end() ? &timings.back() : &*position;
+}
+
+int ResourceLibrary::cycles(const std::string& op_type, int64_t width) const {
+    const OperationTiming* timing = this->find(op_type, width);
+    return timing != nullptr ? timing->cycles : class_cycles(op_type);
+}
+
+double ResourceLibrary::delay(const std::string& op_type, int64_t width) const {
+    const OperationTiming* timing = this->find(op_type, width);
+    return timing != nullptr ? timing->delay : -1.0;
+}
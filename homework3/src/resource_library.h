@@ -0,0 +1,52 @@
+#ifndef RESOURCE_LIBRARY_H
+#define RESOURCE_LIBRARY_H
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Characterization of one operation type at one data width
+struct OperationTiming {
+    int64_t width;
+    int cycles;      // states the operation occupies
+    double delay;    // combinational delay in ns, used for chaining
+};
+
+// Cycles and delay of every operation type by data width. Operations take the entry of
+// the smallest listed width that holds them (the widest one beyond that); types without
+// entries keep the cycles of their resource class and are never chained.
+//
+// The defaults merge homework1's DPCL_LAT.txt (Vivado delays at 2 to 64 bits) and the
+// latency_values table of homework2 (1 to 64 bits), taking the slower of the two. The
+// widest entry of each type keeps the cycles of its resource class; narrower ones need
+// proportionally fewer, rounded up, since their delay is a fraction of the widest one.
+class ResourceLibrary {
+public:
+    static ResourceLibrary& instance();
+
+    // Replaces the library with the "<opType> <width> <cycles> <delayNs>" lines of a file
+    // ('#' starts a comment). Throws HlsError on unreadable files and malformed lines.
+    // Lookups are not guarded, so no other thread may use the library meanwhile.
+    void load(const std::string& path);
+    // Writes the library in the format load() reads
+    void write(std::ostream& out) const;
+
+    // nullptr when the type has no entry
+    const OperationTiming* find(const std::string& op_type, int64_t width) const;
+    // Cycles of the operation, the cycles of its resource class when it has no entry
+    int cycles(const std::string& op_type, int64_t width) const;
+    // Delay in ns of the operation, negative when it has no entry
+    double delay(const std::string& op_type, int64_t width) const;
+
+    // Entries of every operation type ordered by width
+    const std::map<std::string, std::vector<OperationTiming>>& entries() const { return this->timings; }
+
+private:
+    ResourceLibrary();
+
+    std::map<std::string, std::vector<OperationTiming>> timings;
+};
+
+#endif
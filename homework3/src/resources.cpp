@@ -0,0 +1,48 @@
+#include "resources.h"
+
+ResourceRegistry::ResourceRegistry() {
+    // Default resource classes of the scheduler
+    this->register_class({"ADD_SUB", "adder/subtractor", 1, {"ADD", "SUB", "INC", "DEC"}});
+    this->register_class({"MUL", "multiplier", 2, {"MUL"}});
+    this->register_class({"LOG", "logic/logical", 1, {"COMP", "MUX2x1", "SHL", "SHR", "IF"}});
+    this->register_class({"DIV_MOD", "divider/modulo", 3, {"DIV", "MOD"}});
+}
+
+ResourceRegistry& ResourceRegistry::instance() {
+    static ResourceRegistry registry;
+    return registry;
+}
+
+int ResourceRegistry::register_class(const ResourceClass& resource_class) {
+    int id = this->classes.size();
+    this->classes.push_back(resource_class);
+    this->resource_ids[resource_class.resource] = id;
+    this->name_ids[resource_class.name] = id;
+    for (const auto& op_type : resource_class.op_types) {
+        this->op_type_ids[op_type] = id;
+    }
+    return id;
+}
+
+int ResourceRegistry::id_of_op_type(const std::string& op_type) const {
+    auto it = this->op_type_ids.find(op_type);
+    return it == this->op_type_ids.end() ? -1 : it->second;
+}
+
+int ResourceRegistry::id_of_resource(const std::string& resource) const {
+    auto it = this->resource_ids.find(resource);
+    return it == this->resource_ids.end() ? -1 : it->second;
+}
+
+int ResourceRegistry::id_of_name(const std::string& name) const {
+    auto it = this->name_ids.find(name);
+    return it == this->name_ids.end() ? -1 : it->second;
+}
+
+const ResourceClass& ResourceRegistry::at(int id) const {
+    return this->classes.at(id);
+}
+
+size_t ResourceRegistry::size() const {
+    return this->classes.size();
+}
@@ -0,0 +1,43 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// A class of datapath resources that the scheduler balances (e.g. all adders/subtractors)
+struct ResourceClass {
+    std::string name;                   // short name used by the scheduler, e.g. "ADD_SUB"
+    std::string resource;               // resource description attached to operations, e.g. "adder/subtractor"
+    int cycles;                         // latency of the widest operations of this class (narrower ones: see ResourceLibrary)
+    std::vector<std::string> op_types;  // operation types (Operation::opType) executed by this class
+};
+
+// Maps resource classes to dense integer ids once, so the scheduler can index
+// its distribution matrix instead of comparing strings in the inner loops.
+// New classes are added with register_class before parsing the netlist, and before
+// any other thread uses the registry.
+class ResourceRegistry {
+public:
+    static ResourceRegistry& instance();
+
+    int register_class(const ResourceClass& resource_class);
+
+    // All lookups return -1 when nothing is registered under the key
+    int id_of_op_type(const std::string& op_type) const;
+    int id_of_resource(const std::string& resource) const;
+    int id_of_name(const std::string& name) const;
+
+    const ResourceClass& at(int id) const;
+    size_t size() const;
+
+private:
+    ResourceRegistry();
+
+    std::vector<ResourceClass> classes;
+    std::unordered_map<std::string, int> op_type_ids;
+    std::unordered_map<std::string, int> resource_ids;
+    std::unordered_map<std::string, int> name_ids;
+};
+
+#endif
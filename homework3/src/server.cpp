@@ -0,0 +1,554 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server.h"
+#include "hlsyn.h"
+#include "NetlistLexer.h"
+#include "VerilogGenerator.h"
+#include "fds.h"
+#include "list_scheduler.h"
+#include "hls_error.h"
+#include "thread_pool.h"
+#include "number_parsing.h"
+
+namespace {
+
+// Least recently used entries are dropped once more than capacity are stored
+template <typename Value>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity(capacity) {}
+
+    std::shared_ptr<Value> find(const std::string& key) {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+
+    void insert(const std::string& key, std::shared_ptr<Value> value) {
+        auto found = index.find(key);
+        if (found != index.end()) {
+            entries.erase(found->second);
+            index.erase(found);
+        }
+        entries.emplace_front(key, std::move(value));
+        index[key] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+private:
+    size_t capacity;
+    std::list<std::pair<std::string, std::shared_ptr<Value>>> entries;
+    std::unordered_map<std::string, typename std::list<std::pair<std::string, std::shared_ptr<Value>>>::iterator> index;
+};
+
+// A parsed design with the parts of the schedule that do not depend on the latency:
+// ASAP times and ALAP times relative to the latency (alap_time = latency + alap_offset)
+struct ServedDesign {
+    hlsyn::Design design;
+    std::vector<int64_t> asap;
+    std::vector<int64_t> alap_offset;
+    int64_t critical_path = 0;
+};
+
+struct CompileRequest {
+    std::string path;
+    std::string source;
+    bool has_source = false;
+    int64_t latency = 0;
+    std::string scheduler = "fds";
+    std::string resources;
+    std::string module = "HLSM";
+    bool shutdown = false;
+};
+
+struct CompileReply {
+    hlsyn::StatusCode code = hlsyn::StatusCode::ok;
+    std::string text;   // Verilog, or the error message
+};
+
+const char* status_name(hlsyn::StatusCode code) {
+    switch (code) {
+        case hlsyn::StatusCode::ok: return "ok";
+        case hlsyn::StatusCode::invalid_argument: return "invalid_argument";
+        case hlsyn::StatusCode::io_error: return "io_error";
+        case hlsyn::StatusCode::parse_error: return "parse_error";
+        case hlsyn::StatusCode::unschedulable: return "unschedulable";
+        default: return "internal_error";
+    }
+}
+
+hlsyn::StatusCode status_code(const std::string& name) {
+    for (auto code : {hlsyn::StatusCode::ok, hlsyn::StatusCode::invalid_argument, hlsyn::StatusCode::io_error,
+                      hlsyn::StatusCode::parse_error, hlsyn::StatusCode::unschedulable}) {
+        if (name == status_name(code)) {
+            return code;
+        }
+    }
+    return hlsyn::StatusCode::internal_error;
+}
+
+// Buffered reads from a socket
+class SocketReader {
+public:
+    explicit SocketReader(int fd) : fd(fd) {}
+
+    bool read_line(std::string& line) {
+        line.clear();
+        while (true) {
+            size_t newline = buffer.find('\n', offset);
+            if (newline != std::string::npos) {
+                line = buffer.substr(offset, newline - offset);
+                offset = newline + 1;
+                return true;
+            }
+            if (!fill()) {
+                return false;
+            }
+        }
+    }
+
+    bool read_bytes(size_t count, std::string& bytes) {
+        while (buffer.size() - offset < count) {
+            if (!fill()) {
+                return false;
+            }
+        }
+        bytes = buffer.substr(offset, count);
+        offset += count;
+        return true;
+    }
+
+private:
+    int fd;
+    std::string buffer;
+    size_t offset = 0;
+
+    bool fill() {
+        buffer.erase(0, offset);
+        offset = 0;
+        char chunk[65536];
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer.append(chunk, received);
+        return true;
+    }
+};
+
+bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t written = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        sent += written;
+    }
+    return true;
+}
+
+// Reads the next request; returns false at the end of the connection. A malformed request
+// is returned with its error in message.
+bool read_request(SocketReader& reader, CompileRequest& request, std::string& message) {
+    request = CompileRequest();
+    message.clear();
+    std::string line;
+    bool any = false;
+    int64_t source_size = -1;
+    while (reader.read_line(line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            if (!any) {
+                continue;
+            }
+            if (source_size >= 0 && !reader.read_bytes(source_size, request.source)) {
+                return false;
+            }
+            return true;
+        }
+        any = true;
+        size_t space = line.find(' ');
+        std::string key = line.substr(0, space);
+        std::string value = space == std::string::npos ? "" : line.substr(space + 1);
+        if (key == "path") {
+            request.path = value;
+        } else if (key == "source") {
+            if (!parse_integer(value, source_size) || source_size < 0) {
+                message = "Error: Invalid source size '" + value + "'";
+                source_size = -1;
+            }
+            request.has_source = true;
+        } else if (key == "latency") {
+            if (!parse_integer(value, request.latency)) {
+                message = "Error: Invalid latency '" + value + "'";
+            }
+        } else if (key == "scheduler") {
+            request.scheduler = value;
+        } else if (key == "resources") {
+            request.resources = value;
+        } else if (key == "module") {
+            request.module = value;
+        } else if (key == "shutdown") {
+            request.shutdown = true;
+        } else if (message.empty()) {
+            message = "Error: Unknown request key '" + key + "'";
+        }
+    }
+    return false;
+}
+
+class CompileServer {
+public:
+    // FDS evaluates its candidates on the pool; connections are served on a different pool, so a
+    // thread waiting for FDS tasks never picks up a connection that blocks on its socket
+    CompileServer(size_t cache_designs, ThreadPool* pool) : designs(cache_designs), results(cache_designs * 16), pool(pool) {}
+
+    CompileReply compile(const CompileRequest& request) {
+        auto start = std::chrono::steady_clock::now();
+        CompileReply reply;
+        std::string source;
+        if (request.has_source) {
+            source = request.source;
+        } else {
+            MappedFile file(request.path);
+            if (request.path.empty() || !file.isOpen()) {
+                return {hlsyn::StatusCode::io_error, "Error: Netlist file '" + request.path + "' does not exist."};
+            }
+            source = std::string(file.contents());
+        }
+
+        std::string design_key = std::to_string(hashSource(source)) + ":" + std::to_string(source.size());
+        std::string result_key = design_key + "|" + std::to_string(request.latency) + "|" + request.scheduler + "|" + request.resources + "|" + request.module;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::shared_ptr<CompileReply> cached = results.find(result_key);
+            if (cached != nullptr) {
+                log(request, "result cached", start);
+                return *cached;
+            }
+        }
+
+        bool design_cached = true;
+        std::shared_ptr<ServedDesign> served;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            served = designs.find(design_key);
+        }
+        if (served == nullptr) {
+            design_cached = false;
+            served = std::make_shared<ServedDesign>();
+            hlsyn::Status status = hlsyn::parse_netlist(source, served->design);
+            if (status.ok()) {
+                status = prepare(*served);
+            }
+            if (!status.ok()) {
+                // Parse errors are results too, the same source fails the same way
+                auto failed = std::make_shared<CompileReply>(CompileReply{status.code, status.message});
+                std::lock_guard<std::mutex> lock(mutex);
+                results.insert(result_key, failed);
+                log(request, "parse failed", start);
+                return *failed;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                designs.insert(design_key, served);
+            }
+            for (const auto& warning : served->design.warnings) {
+                // One write per line, workers log concurrently
+                std::cerr << (request.has_source ? std::string("<source>") : request.path) + ": " + warning + "\n" << std::flush;
+            }
+        }
+
+        auto result = std::make_shared<CompileReply>(schedule(*served, request));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.insert(result_key, result);
+        }
+        log(request, design_cached ? "design cached" : "parsed", start);
+        return *result;
+    }
+
+private:
+    std::mutex mutex;
+    LruCache<ServedDesign> designs;
+    LruCache<CompileReply> results;
+    ThreadPool* pool;
+
+    // ASAP at the smallest bound, ALAP at the critical path (the smallest feasible bound)
+    hlsyn::Status prepare(ServedDesign& served) {
+        hlsyn::Status status;
+        try {
+            Graph asap_graph(served.design.graph, 1);
+            FDS asap_fds(&asap_graph, 1);
+            asap_fds.compute_topological_order();
+            asap_fds.asap_scheduler();
+            served.critical_path = std::max<int64_t>(1, asap_fds.critical_path());
+
+            Graph alap_graph(served.design.graph, served.critical_path);
+            FDS alap_fds(&alap_graph, served.critical_path);
+            alap_fds.compute_topological_order();
+            alap_fds.alap_scheduler();
+            for (size_t index = 0; index < asap_graph.vertices.size(); index++) {
+                served.asap.push_back(asap_graph.vertices[index]->asap_time);
+                served.alap_offset.push_back(alap_graph.vertices[index]->alap_time - served.critical_path);
+            }
+        } catch (const HlsError& error) {
+            status.code = hlsyn::status_code(error, hlsyn::StatusCode::unschedulable);
+            status.message = error.what();
+        }
+        return status;
+    }
+
+    CompileReply schedule(const ServedDesign& served, const CompileRequest& request) {
+        if (request.latency < 1) {
+            return {hlsyn::StatusCode::invalid_argument, "Error: Latency must be at least 1, found " + std::to_string(request.latency)};
+        }
+        if (request.scheduler != "fds" && request.scheduler != "list") {
+            return {hlsyn::StatusCode::invalid_argument, "Error: Unknown scheduler '" + request.scheduler + "'"};
+        }
+        hlsyn::StatusCode failure = hlsyn::StatusCode::invalid_argument;
+        try {
+            std::vector<int64_t> resource_limits = ListScheduler::parse_resource_limits(request.resources);
+            failure = hlsyn::StatusCode::internal_error;
+            Graph graph(served.design.graph, request.latency);
+            if (request.scheduler == "list") {
+                ListScheduler list_scheduler(&graph, request.latency, resource_limits);
+                list_scheduler.run_list_scheduler();
+            } else {
+                if (request.latency < served.critical_path) {
+                    return {hlsyn::StatusCode::unschedulable, "Cannot schedule the circuit for " + std::to_string(request.latency) + " cycle latency , increase the latency! Exiting ..."};
+                }
+                for (size_t index = 0; index < graph.vertices.size(); index++) {
+                    graph.vertices[index]->asap_time = served.asap[index];
+                    graph.vertices[index]->alap_time = served.alap_offset[index] + request.latency;
+                }
+                FDS fds(&graph, request.latency, this->pool);
+                fds.compute_topological_order();
+                fds.schedule_time_frames();
+                if (!fds.meets_latency_requirement()) {
+                    return {hlsyn::StatusCode::unschedulable, "Couldn't meet the latency requirement of " + std::to_string(request.latency) + " cycles! Increase the latency, exiting ..."};
+                }
+            }
+            std::ostringstream verilog;
+            VerilogGenerator verilog_generator(served.design.components, served.design.graph.operations, &graph);
+            verilog_generator.generateVerilog(verilog, request.module);
+            return {hlsyn::StatusCode::ok, verilog.str()};
+        } catch (const HlsError& error) {
+            return {hlsyn::status_code(error, failure), error.what()};
+        } catch (const std::exception& error) {
+            return {hlsyn::StatusCode::internal_error, error.what()};
+        }
+    }
+
+    void log(const CompileRequest& request, const char* outcome, std::chrono::steady_clock::time_point start) {
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::ostringstream line;
+        line << (request.has_source ? "<source>" : request.path) << " latency " << request.latency << " " << request.scheduler
+             << ": " << outcome << ", " << std::fixed << std::setprecision(2) << milliseconds << " ms\n";
+        std::cout << line.str() << std::flush;
+    }
+};
+
+// Connections being served, so a shutdown can end the reads of idle clients
+class ClientSet {
+public:
+    // false once stopping, the caller closes the connection itself then
+    bool add(int fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return false;
+        }
+        fds.insert(fd);
+        return true;
+    }
+
+    // Closed under the lock, so stop() never shuts down a descriptor reused meanwhile
+    void remove(int fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fds.erase(fd);
+        ::close(fd);
+    }
+
+    // Blocked reads return end of file; requests in flight still get their reply
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (int fd : fds) {
+            ::shutdown(fd, SHUT_RD);
+        }
+    }
+
+    bool stopped() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stopping;
+    }
+
+private:
+    std::mutex mutex;
+    std::set<int> fds;
+    bool stopping = false;
+};
+
+}
+
+int run_compile_server(const ServerOptions& options) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (options.socket_path.empty() || options.socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Invalid socket path '" << options.socket_path << "'\n";
+        return 1;
+    }
+    options.socket_path.copy(address.sun_path, options.socket_path.size());
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(options.socket_path.c_str());
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 64) != 0) {
+        std::cerr << "Error: Unable to listen on socket '" << options.socket_path << "'\n";
+        if (listener >= 0) {
+            ::close(listener);
+        }
+        return 1;
+    }
+    std::cout << "Serving on " << options.socket_path << std::endl;
+
+    // The accepting thread only hands out connections, the workers serve them
+    ThreadPool pool(options.workers + 1);
+    ThreadPool fds_pool(options.workers);
+    CompileServer server(options.cache_designs, &fds_pool);
+    ClientSet clients;
+    TaskGroup group;
+    while (!clients.stopped()) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (clients.stopped()) {
+                break;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                // Out of descriptors or memory until some client disconnects
+                std::cerr << "Warning: accept failed (" << std::strerror(errno) << "), retrying\n";
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            std::cerr << "Error: accept failed (" << std::strerror(errno) << "), stopping\n";
+            clients.stop();
+            break;
+        }
+        if (!clients.add(client)) {
+            ::close(client);
+            break;
+        }
+        pool.run(group, [&server, &clients, listener, client]() {
+            SocketReader reader(client);
+            CompileRequest request;
+            std::string message;
+            while (read_request(reader, request, message)) {
+                if (request.shutdown) {
+                    send_all(client, "ok 0\n");
+                    clients.stop();
+                    // Wakes the accepting thread
+                    ::shutdown(listener, SHUT_RDWR);
+                    break;
+                }
+                CompileReply reply = message.empty() ? server.compile(request) : CompileReply{hlsyn::StatusCode::invalid_argument, message};
+                std::string header = reply.code == hlsyn::StatusCode::ok
+                    ? "ok " + std::to_string(reply.text.size()) + "\n"
+                    : "error " + std::string(status_name(reply.code)) + " " + std::to_string(reply.text.size()) + "\n";
+                if (!send_all(client, header + reply.text)) {
+                    break;
+                }
+            }
+            clients.remove(client);
+        });
+    }
+    pool.wait(group);
+    ::close(listener);
+    ::unlink(options.socket_path.c_str());
+    return 0;
+}
+
+int run_compile_client(const std::string& socket_path, const std::string& c_file, int64_t latency, const std::string& verilog_file, const std::string& scheduler, const std::string& resources) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket_path.size() >= sizeof(address.sun_path) || fd < 0) {
+        std::cerr << "Error: Invalid socket path '" << socket_path << "'\n";
+        return 1;
+    }
+    socket_path.copy(address.sun_path, socket_path.size());
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Error: Unable to connect to compile server at '" << socket_path << "'\n";
+        ::close(fd);
+        return 1;
+    }
+
+    std::string request = "path " + std::filesystem::absolute(c_file).string() + "\n" +
+                          "latency " + std::to_string(latency) + "\n" +
+                          "scheduler " + scheduler + "\n";
+    if (!resources.empty()) {
+        request += "resources " + resources + "\n";
+    }
+    request += "\n";
+
+    SocketReader reader(fd);
+    std::string header;
+    std::string body;
+    if (!send_all(fd, request) || !reader.read_line(header)) {
+        std::cerr << "Error: Compile server at '" << socket_path << "' closed the connection\n";
+        ::close(fd);
+        return 1;
+    }
+    std::istringstream fields(header);
+    std::string outcome;
+    std::string status = "ok";
+    size_t size = 0;
+    fields >> outcome;
+    if (outcome == "error") {
+        fields >> status;
+    }
+    fields >> size;
+    bool received = reader.read_bytes(size, body);
+    ::close(fd);
+    if (!received) {
+        std::cerr << "Error: Compile server at '" << socket_path << "' closed the connection\n";
+        return 1;
+    }
+
+    if (outcome != "ok") {
+        // Reported the way a local run reports it
+        bool unschedulable = status_code(status) == hlsyn::StatusCode::unschedulable;
+        (unschedulable ? std::cout : std::cerr) << body << std::endl;
+        return unschedulable ? 0 : 1;
+    }
+    std::ofstream out(verilog_file);
+    out << body;
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+
+// Local compile server. A request is a block of "key value" lines ended by an empty line:
+//
+//   path <cFile>          netlist to compile, read by the server
+//   source <n>            or n bytes of netlist text, sent right after the empty line
+//   latency <N>
+//   scheduler fds|list    (default fds)
+//   resources <limits>    list scheduler units, e.g. mul=2,add_sub=3
+//   module <name>         Verilog module name (default HLSM)
+//   shutdown              stops the server once the running requests finished
+//
+// The reply is "ok <n>\n" followed by n bytes of Verilog, or "error <status> <n>\n" followed
+// by n bytes of message. A connection may send any number of requests.
+//
+// Parsed designs are kept in an LRU keyed by a hash of the source text together with their
+// ASAP times and latency-independent ALAP offsets, and finished results in a second LRU, so
+// repeating or retuning a request skips the front end and the ASAP/ALAP passes.
+struct ServerOptions {
+    std::string socket_path;
+    size_t workers = 1;           // connections served concurrently
+    size_t cache_designs = 64;    // parsed designs kept; 16 results are kept per design
+};
+
+// Serves until a shutdown request arrives; returns the process exit status
+int run_compile_server(const ServerOptions& options);
+
+// Sends one path request to the server and writes the Verilog it returns to verilog_file;
+// returns the process exit status (errors are printed like a local run would)
+int run_compile_client(const std::string& socket_path, const std::string& c_file, int64_t latency, const std::string& verilog_file, const std::string& scheduler, const std::string& resources);
+
+#endif
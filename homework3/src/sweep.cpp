@@ -0,0 +1,125 @@
+#include <iomanip>
+#include <algorithm>
+
+#include "sweep.h"
+#include "graph.h"
+#include "fds.h"
+#include "resources.h"
+#include "list_scheduler.h"
+
+std::vector<SweepPoint> run_latency_sweep(const OperationGraph& operations, int64_t min_latency, int64_t max_latency, ThreadPool& pool, double clock_period) {
+    std::vector<SweepPoint> points;
+    for (int64_t latency = min_latency; latency <= max_latency; latency++) {
+        SweepPoint point;
+        point.latency = latency;
+        points.push_back(point);
+    }
+
+    // ASAP does not depend on the bound, and ALAP only shifts with it
+    Graph reference(operations, max_latency, clock_period);
+    FDS reference_fds(&reference, max_latency);
+    reference_fds.compute_topological_order();
+    reference_fds.asap_scheduler();
+    int64_t critical_path = reference_fds.critical_path();
+    if (critical_path > max_latency) {
+        return points;
+    }
+    reference_fds.alap_scheduler();
+
+    TaskGroup group;
+    for (auto& point : points) {
+        if (point.latency < critical_path) {
+            continue;
+        }
+        pool.run(group, [&operations, &reference, &point, max_latency, clock_period]() {
+            Graph graph(operations, point.latency, clock_period);
+            int64_t shift = max_latency - point.latency;
+            for (size_t index = 0; index < graph.vertices.size(); index++) {
+                graph.vertices[index]->asap_time = reference.vertices[index]->asap_time;
+                graph.vertices[index]->alap_time = reference.vertices[index]->alap_time - shift;
+            }
+
+            FDS fds(&graph, point.latency);
+            fds.compute_topological_order();
+            fds.schedule_time_frames();
+            point.peaks = graph.peak_resource_usage();
+            point.feasible = fds.meets_latency_requirement();
+        });
+    }
+    pool.wait(group);
+
+    // Latencies increase along the sweep, so only earlier points can dominate a later one
+    for (size_t index = 0; index < points.size(); index++) {
+        if (!points[index].feasible) {
+            continue;
+        }
+        points[index].pareto = true;
+        for (size_t other = 0; other < index && points[index].pareto; other++) {
+            if (points[other].feasible && std::equal(points[other].peaks.begin(), points[other].peaks.end(), points[index].peaks.begin(), std::less_equal<int64_t>())) {
+                points[index].pareto = false;
+            }
+        }
+    }
+    return points;
+}
+
+void print_sweep_table(const std::vector<SweepPoint>& points, std::ostream& out) {
+    const ResourceRegistry& registry = ResourceRegistry::instance();
+
+    out << std::setw(8) << "Latency";
+    for (size_t resource_id = 0; resource_id < registry.size(); resource_id++) {
+        out << std::setw(10) << registry.at(resource_id).name;
+    }
+    out << std::setw(8) << "Total" << std::setw(8) << "Pareto" << "\n";
+
+    for (const auto& point : points) {
+        out << std::setw(8) << point.latency;
+        if (!point.feasible) {
+            out << "  infeasible\n";
+            continue;
+        }
+        int64_t total = 0;
+        for (const auto& peak : point.peaks) {
+            out << std::setw(10) << peak;
+            total += peak;
+        }
+        out << std::setw(8) << total << std::setw(8) << (point.pareto ? "*" : "") << "\n";
+    }
+}
+
+LatencySearch find_minimum_latency(const OperationGraph& operations, bool list_scheduler, const std::vector<int64_t>& resource_limits, double clock_period) {
+    LatencySearch search;
+
+    // The probability vectors are sized by the bound, so probe ASAP with the smallest one
+    Graph reference(operations, 1, clock_period);
+    FDS reference_fds(&reference, 1);
+    reference_fds.compute_topological_order();
+    reference_fds.asap_scheduler();
+    search.lower_bound = reference_fds.critical_path();
+    search.latency = search.lower_bound;
+
+    if (list_scheduler) {
+        ListScheduler scheduler(&reference, search.lower_bound, resource_limits);
+        scheduler.compute_priorities();
+        search.latency = scheduler.perform_scheduling();
+        return search;
+    }
+
+    // Scheduling every operation back to back always fits, so the walk terminates
+    int64_t serial_latency = 0;
+    for (const auto& vertex : reference.vertices) {
+        serial_latency += vertex->latency;
+    }
+    for (; search.latency < serial_latency; search.latency++) {
+        Graph graph(operations, search.latency, clock_period);
+        FDS fds(&graph, search.latency);
+        fds.compute_topological_order();
+        fds.asap_scheduler();
+        fds.alap_scheduler();
+        fds.schedule_time_frames();
+        if (fds.meets_latency_requirement()) {
+            break;
+        }
+    }
+    return search;
+}
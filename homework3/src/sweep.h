@@ -0,0 +1,38 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "OpPostProcess.h"
+#include "thread_pool.h"
+
+// Result of scheduling the design at one latency bound
+struct SweepPoint {
+    int64_t latency;
+    bool feasible = false;
+    std::vector<int64_t> peaks;   // peak resource usage by resource id
+    bool pareto = false;          // no smaller latency needs at most as many units of every class
+};
+
+// Schedules the operation graph with FDS for every latency in [min_latency, max_latency].
+// ASAP is computed once; the ALAP of each bound is the ALAP of max_latency shifted down,
+// and the latencies are scheduled concurrently on the pool. A positive clock period chains
+// operations as in Graph.
+std::vector<SweepPoint> run_latency_sweep(const OperationGraph& operations, int64_t min_latency, int64_t max_latency, ThreadPool& pool, double clock_period = 0.0);
+
+// Prints latency vs. peak resource count per class, marking the Pareto-optimal points
+void print_sweep_table(const std::vector<SweepPoint>& points, std::ostream& out);
+
+struct LatencySearch {
+    int64_t lower_bound;   // critical path length from ASAP
+    int64_t latency;       // smallest latency the scheduler meets
+};
+
+// Finds the smallest latency the chosen scheduler can meet. FDS walks up from the
+// critical path until a bound is met; the list scheduler needs exactly the length
+// of its resource-constrained schedule.
+LatencySearch find_minimum_latency(const OperationGraph& operations, bool list_scheduler, const std::vector<int64_t>& resource_limits, double clock_period = 0.0);
+
+#endif
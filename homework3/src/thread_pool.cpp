@@ -0,0 +1,141 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+// Queue owned by the current thread; external threads share queue 0
+thread_local size_t current_queue = 0;
+thread_local const void* current_pool = nullptr;
+}
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    size_t worker_count = num_threads > 1 ? num_threads - 1 : 0;
+    for (size_t iter = 0; iter <= worker_count; iter++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t iter = 1; iter <= worker_count; iter++) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, iter);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::run(TaskGroup& group, std::function<void()> task) {
+    group.pending++;
+
+    // Workers keep their own tasks local, other threads spread them round robin
+    size_t index = current_pool == this ? current_queue : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back({std::move(task), &group});
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::wait(TaskGroup& group) {
+    size_t index = current_pool == this ? current_queue : 0;
+    while (group.pending > 0) {
+        if (!try_run_one(index)) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (group.error) {
+        std::exception_ptr error = group.error;
+        group.error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (workers.empty() || end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group;
+    for (size_t chunk = begin; chunk < end; chunk += grain) {
+        size_t chunk_end = std::min(end, chunk + grain);
+        run(group, [&body, chunk, chunk_end]() { body(chunk, chunk_end); });
+    }
+    wait(group);
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    current_queue = index;
+    current_pool = this;
+    while (true) {
+        if (try_run_one(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::try_run_one(size_t index) {
+    Task task;
+    bool found = false;
+
+    // Own queue first (newest task, still warm in cache), then steal the oldest task of the others
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        if (!queues[index]->tasks.empty()) {
+            task = std::move(queues[index]->tasks.back());
+            queues[index]->tasks.pop_back();
+            found = true;
+        }
+    }
+    for (size_t offset = 1; !found && offset < queues.size(); offset++) {
+        WorkQueue& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+    queued--;
+    execute(task);
+    return true;
+}
+
+void ThreadPool::execute(Task& task) {
+    try {
+        task.function();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(task.group->error_mutex);
+        if (!task.group->error) {
+            task.group->error = std::current_exception();
+        }
+    }
+    task.group->pending--;
+}
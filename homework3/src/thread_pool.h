@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Set of tasks that can be waited on together
+class TaskGroup {
+public:
+    std::atomic<size_t> pending{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+// Work-stealing thread pool. Every worker owns a task deque: it pops its own
+// tasks from the back and steals from the front of the others when idle.
+// Threads waiting on a group keep executing tasks, so nested parallel_for
+// calls from inside a task do not deadlock.
+class ThreadPool {
+public:
+    // num_threads counts the calling thread, so num_threads - 1 workers are spawned
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+
+    size_t size() const;
+
+    void run(TaskGroup& group, std::function<void()> task);
+    // Helps executing tasks until every task of the group finished, rethrows the first failure
+    void wait(TaskGroup& group);
+
+    // Runs body(chunk_begin, chunk_end) over [begin, end) in chunks of at most grain indices
+    void parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+private:
+    struct Task {
+        std::function<void()> function;
+        TaskGroup* group;
+    };
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> next_queue{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void worker_loop(size_t index);
+    bool try_run_one(size_t index);
+    void execute(Task& task);
+};
+
+#endif
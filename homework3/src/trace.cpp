@@ -0,0 +1,156 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "trace.h"
+
+namespace {
+
+struct TraceEvent {
+    char phase;             // 'X' complete span, 'C' counter
+    std::string category;
+    std::string name;
+    double timestamp;       // microseconds since start_trace
+    double duration;
+    int thread;
+    std::vector<std::pair<std::string, std::string>> args;
+};
+
+struct TraceLog {
+    std::atomic<bool> enabled{false};
+    std::chrono::steady_clock::time_point origin;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    std::unordered_map<std::thread::id, int> threads;   // small ids in order of appearance
+
+    static TraceLog& instance() {
+        static TraceLog log;
+        return log;
+    }
+
+    double since_origin(std::chrono::steady_clock::time_point time) const {
+        return std::chrono::duration<double, std::micro>(time - origin).count();
+    }
+
+    void record(TraceEvent event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto inserted = threads.emplace(std::this_thread::get_id(), threads.size() + 1);
+        event.thread = inserted.first->second;
+        events.push_back(std::move(event));
+    }
+};
+
+std::string json_string(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            quoted += escaped;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+}
+
+void start_trace() {
+    TraceLog& log = TraceLog::instance();
+    std::lock_guard<std::mutex> lock(log.mutex);
+    log.events.clear();
+    log.origin = std::chrono::steady_clock::now();
+    log.enabled = true;
+}
+
+bool tracing() {
+    return TraceLog::instance().enabled.load(std::memory_order_relaxed);
+}
+
+bool write_trace(const std::string& path) {
+    TraceLog& log = TraceLog::instance();
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(log.mutex);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t index = 0; index < log.events.size(); index++) {
+        const TraceEvent& event = log.events[index];
+        out << "{\"ph\":\"" << event.phase << "\",\"cat\":" << json_string(event.category) << ",\"name\":" << json_string(event.name)
+            << ",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << event.timestamp;
+        if (event.phase == 'X') {
+            out << ",\"dur\":" << event.duration;
+        }
+        if (!event.args.empty()) {
+            out << ",\"args\":{";
+            for (size_t arg = 0; arg < event.args.size(); arg++) {
+                out << (arg > 0 ? "," : "") << json_string(event.args[arg].first) << ":" << event.args[arg].second;
+            }
+            out << "}";
+        }
+        out << "}" << (index + 1 < log.events.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+    return static_cast<bool>(out);
+}
+
+void trace_counters(const char* name, const std::vector<std::pair<std::string, int64_t>>& values) {
+    if (!tracing()) {
+        return;
+    }
+    TraceLog& log = TraceLog::instance();
+    TraceEvent event;
+    event.phase = 'C';
+    event.category = "counter";
+    event.name = name;
+    event.timestamp = log.since_origin(std::chrono::steady_clock::now());
+    event.duration = 0.0;
+    for (const auto& value : values) {
+        event.args.push_back({value.first, std::to_string(value.second)});
+    }
+    log.record(std::move(event));
+}
+
+TraceSpan::TraceSpan(const char* category, const char* name) : active(tracing()), category(category), name(name) {
+    if (this->active) {
+        this->start = std::chrono::steady_clock::now();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (!this->active) {
+        return;
+    }
+    TraceLog& log = TraceLog::instance();
+    auto end = std::chrono::steady_clock::now();
+    TraceEvent event;
+    event.phase = 'X';
+    event.category = this->category;
+    event.name = this->name;
+    event.timestamp = log.since_origin(this->start);
+    event.duration = std::chrono::duration<double, std::micro>(end - this->start).count();
+    event.args = std::move(this->args);
+    log.record(std::move(event));
+}
+
+void TraceSpan::arg(const char* key, int64_t value) {
+    if (this->active) {
+        this->args.push_back({key, std::to_string(value)});
+    }
+}
+
+void TraceSpan::arg(const char* key, const std::string& value) {
+    if (this->active) {
+        this->args.push_back({key, json_string(value)});
+    }
+}
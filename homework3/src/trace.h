@@ -0,0 +1,41 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Timeline of the compiler phases in the Chrome trace event format, viewable in
+// chrome://tracing or ui.perfetto.dev. Nothing is recorded until start_trace(),
+// so a span costs a single check while tracing is off.
+void start_trace();
+bool tracing();
+// Writes everything recorded so far; returns false when the file cannot be written
+bool write_trace(const std::string& path);
+
+// Samples of named counters at the current time, shown as one counter track
+void trace_counters(const char* name, const std::vector<std::pair<std::string, int64_t>>& values);
+
+// Records the time from construction to destruction as one span on the calling thread
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Extra values shown with the span; ignored while tracing is off
+    void arg(const char* key, int64_t value);
+    void arg(const char* key, const std::string& value);
+
+private:
+    bool active;
+    const char* category;
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    std::vector<std::pair<std::string, std::string>> args;   // values already JSON encoded
+};
+
+#endif
@@ -43,21 +43,12 @@ void FDS::print_fds_prob(){
 }
 
 void FDS::print_type_prob(){
-    std::cout << "ADD_SUB distributions:" << std::endl;
-    for (int iter = 0; iter < this->latency_requirement; iter++) {
-        std::cout << iter+1 << ":" << this->add_sub_prob.at(iter) << std::endl;
-    }
-    std::cout << "MUL distributions:" << std::endl;
-    for (int iter = 0; iter < this->latency_requirement; iter++) {
-        std::cout << iter+1 << ":" << this->mul_prob.at(iter) << std::endl;
-    }
-    std::cout << "LOG distributions:" << std::endl;
-    for (int iter = 0; iter < this->latency_requirement; iter++) {
-        std::cout << iter+1 << ":" << this->log_prob.at(iter) << std::endl;
-    }
-    std::cout << "DIV_MOD distributions:" << std::endl;
-    for (int iter = 0; iter < this->latency_requirement; iter++) {
-        std::cout << iter+1 << ":" << this->div_mod_prob.at(iter) << std::endl;
+    for (size_t resource_id = 0; resource_id < this->num_resources; resource_id++) {
+        std::cout << ResourceRegistry::instance().at(resource_id).name << " distributions:" << std::endl;
+        const double *type_prob = this->type_distribution(resource_id);
+        for (int iter = 0; iter < this->latency_requirement; iter++) {
+            std::cout << iter+1 << ":" << type_prob[iter] << std::endl;
+        }
     }
     std::cout << "\n";
 }
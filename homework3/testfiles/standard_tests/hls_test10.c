@@ -0,0 +1,7 @@
+input Int32 a, b, c
+
+output Int1 z, y, w
+
+z = (a + b) > c
+y = a != b
+w = (a - c) >= b
@@ -0,0 +1,10 @@
+input Int32 a, b, c, d
+
+output Int32 z
+
+variable Int32 x, y
+
+x = a + b
+y = x + c
+x = y + d
+z = x + a
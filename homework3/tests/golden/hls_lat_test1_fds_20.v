@@ -0,0 +1,66 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [15:0] a,
+	input signed [15:0] b,
+	input signed [15:0] c,
+	input signed [15:0] d,
+	input signed [15:0] e,
+	output reg signed [15:0] i
+);
+	reg signed [15:0] f;
+	reg signed [15:0] g;
+	reg signed [15:0] h;
+
+	reg [2:0] state;
+
+	localparam Wait = 3'b000;
+	localparam Final = 3'b101;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			i <= 0;
+			f <= 0;
+			g <= 0;
+			h <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						f <= a + b;
+						state <= 2;
+				end
+				2: begin
+						g <= f + c;
+						state <= 3;
+				end
+				3: begin
+						h <= g + d;
+						state <= 4;
+				end
+				4: begin
+						i <= h + e;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
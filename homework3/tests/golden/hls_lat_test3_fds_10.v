@@ -0,0 +1,81 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [15:0] a,
+	input signed [15:0] b,
+	input signed [15:0] c,
+	input signed [15:0] d,
+	input signed [15:0] e,
+	input signed [15:0] f,
+	input signed [15:0] g,
+	input signed [15:0] h,
+	output reg signed [15:0] i,
+	output reg signed [15:0] j,
+	output reg signed [15:0] k,
+	output reg signed [15:0] l
+);
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1001;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			i <= 0;
+			j <= 0;
+			k <= 0;
+			l <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						i <= a * b;
+						state <= 2;
+				end
+				2: begin
+						j <= c * d;
+						state <= 3;
+				end
+				3: begin
+						k <= e * f;
+						state <= 4;
+				end
+				4: begin
+						l <= g * h;
+						state <= 5;
+				end
+				5: begin
+						state <= 6;
+				end
+				6: begin
+						state <= 7;
+				end
+				7: begin
+						state <= 8;
+				end
+				8: begin
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,71 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [15:0] a,
+	input signed [15:0] b,
+	input signed [15:0] c,
+	input signed [15:0] d,
+	input signed [15:0] e,
+	input signed [15:0] f,
+	input signed [15:0] g,
+	output reg signed [15:0] j,
+	output reg signed [15:0] l
+);
+	reg signed [15:0] h;
+	reg signed [15:0] i;
+	reg signed [15:0] k;
+
+	reg [2:0] state;
+
+	localparam Wait = 3'b000;
+	localparam Final = 3'b101;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			h <= 0;
+			i <= 0;
+			k <= 0;
+			j <= 0;
+			l <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						h <= a + b;
+						k <= e * f;
+						state <= 2;
+				end
+				2: begin
+						i <= h + c;
+						state <= 3;
+				end
+				3: begin
+						j <= i + d;
+						l <= k * g;
+						state <= 4;
+				end
+				4: begin
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,91 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] a,
+	input signed [31:0] b,
+	input signed [31:0] c,
+	output reg z,
+	output reg y,
+	output reg w
+);
+	reg signed [31:0] _t0;
+	reg _t1;
+	reg signed [31:0] _t2;
+	reg _t3;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			y <= 0;
+			w <= 0;
+			_t0 <= 0;
+			_t1 <= 0;
+			_t2 <= 0;
+			_t3 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						_t1 <= a == b;
+						_t2 <= a - c;
+						state <= 2;
+				end
+				2: begin
+						_t3 <= _t2 < b;
+						state <= 3;
+				end
+				3: begin
+						state <= 4;
+				end
+				4: begin
+						state <= 5;
+				end
+				5: begin
+						state <= 6;
+				end
+				6: begin
+						state <= 7;
+				end
+				7: begin
+						state <= 8;
+				end
+				8: begin
+						w <= _t3 == 0;
+						state <= 9;
+				end
+				9: begin
+						_t0 <= a + b;
+						y <= _t1 == 0;
+						state <= 10;
+				end
+				10: begin
+						z <= _t0 > c;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,76 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] a,
+	input signed [31:0] b,
+	input signed [31:0] c,
+	output reg z,
+	output reg y,
+	output reg w
+);
+	reg signed [31:0] _t0;
+	reg _t1;
+	reg signed [31:0] _t2;
+	reg _t3;
+
+	reg [2:0] state;
+
+	localparam Wait = 3'b000;
+	localparam Final = 3'b110;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			y <= 0;
+			w <= 0;
+			_t0 <= 0;
+			_t1 <= 0;
+			_t2 <= 0;
+			_t3 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						_t1 <= a == b;
+						_t2 <= a - c;
+						state <= 2;
+				end
+				2: begin
+						_t0 <= a + b;
+						_t3 <= _t2 < b;
+						state <= 3;
+				end
+				3: begin
+						w <= _t3 == 0;
+						state <= 4;
+				end
+				4: begin
+						z <= _t0 > c;
+						state <= 5;
+				end
+				5: begin
+						y <= _t1 == 0;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,70 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input [15:0] a,
+	input [15:0] b,
+	input [15:0] c,
+	output reg [7:0] z,
+	output reg [15:0] x
+);
+	reg [7:0] d;
+	reg [7:0] e;
+	reg [7:0] f;
+	reg [7:0] g;
+
+	reg [2:0] state;
+
+	localparam Wait = 3'b000;
+	localparam Final = 3'b101;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			x <= 0;
+			d <= 0;
+			e <= 0;
+			f <= 0;
+			g <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						d <= a + b;
+						f <= a * c;
+						state <= 2;
+				end
+				2: begin
+						e <= a + c;
+						state <= 3;
+				end
+				3: begin
+						g <= d > e;
+						x <= f - d;
+						state <= 4;
+				end
+				4: begin
+						z <= g ? d : e;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,89 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input [15:0] a,
+	input [15:0] b,
+	input [15:0] c,
+	output reg [7:0] z,
+	output reg [15:0] x
+);
+	reg [7:0] d;
+	reg [7:0] e;
+	reg [7:0] f;
+	reg [7:0] g;
+	reg [15:0] a_s0;
+	reg [15:0] b_s0;
+	reg [15:0] c_s0;
+	reg [7:0] z_s1;
+	reg [7:0] d_s0;
+	reg [7:0] d_s1;
+	reg [7:0] e_s0;
+	reg [7:0] e_s1;
+	reg [7:0] f_s0;
+	reg [7:0] f_s1;
+	reg [7:0] g_s1;
+
+	// 2 stages, a new input set every 2 cycles
+	reg slot;
+	reg [1:0] valid;
+	wire advance = slot == 1;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			slot <= 1;
+			valid <= 0;
+			Done <= 0;
+			z <= 0;
+			x <= 0;
+			a_s0 <= 0;
+			b_s0 <= 0;
+			c_s0 <= 0;
+			z_s1 <= 0;
+			d_s0 <= 0;
+			d_s1 <= 0;
+			e_s0 <= 0;
+			e_s1 <= 0;
+			f_s0 <= 0;
+			f_s1 <= 0;
+			g_s1 <= 0;
+		end
+		else begin
+			Done <= advance && valid[1];
+			if (advance) begin
+				valid <= {valid[0:0], Start};
+				slot <= Start || |valid[0:0] ? 0 : 1;
+				a_s0 <= a;
+				b_s0 <= b;
+				c_s0 <= c;
+				d_s1 <= d_s0;
+				e_s1 <= e_s0;
+				f_s1 <= f_s0;
+				if (valid[1]) begin
+					z <= z_s1;
+				end
+			end
+			else begin
+				slot <= slot + 1;
+			end
+			if (valid[0] && slot == 0) begin
+				d_s0 <= a_s0 + b_s0;
+				e_s0 <= a_s0 + c_s0;
+				f_s0 <= a_s0 * c_s0;
+			end
+			if (valid[0] && slot == 1) begin
+				g_s1 <= d_s0 > e_s0;
+			end
+			if (valid[1] && slot == 0) begin
+				z_s1 <= g_s1 ? d_s1 : e_s1;
+			end
+			if (valid[1] && slot == 1) begin
+				x <= f_s1 - d_s1;
+			end
+		end
+	end
+
+endmodule
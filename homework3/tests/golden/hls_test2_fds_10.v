@@ -0,0 +1,97 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] a,
+	input signed [31:0] b,
+	input signed [31:0] c,
+	output reg signed [31:0] z,
+	output reg signed [31:0] x
+);
+	reg signed [31:0] d;
+	reg signed [31:0] e;
+	reg signed [31:0] f;
+	reg signed [31:0] g;
+	reg signed [31:0] h;
+	reg dLTe;
+	reg dEQe;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			x <= 0;
+			d <= 0;
+			e <= 0;
+			f <= 0;
+			g <= 0;
+			h <= 0;
+			dLTe <= 0;
+			dEQe <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						d <= a + b;
+						state <= 2;
+				end
+				2: begin
+						e <= a + c;
+						state <= 3;
+				end
+				3: begin
+						f <= a - b;
+						dEQe <= d == e;
+						dLTe <= d < e;
+						state <= 4;
+				end
+				4: begin
+						g <= dLTe ? d : e;
+						state <= 5;
+				end
+				5: begin
+						h <= dEQe ? g : f;
+						state <= 6;
+				end
+				6: begin
+						state <= 7;
+				end
+				7: begin
+						state <= 8;
+				end
+				8: begin
+						state <= 9;
+				end
+				9: begin
+						z <= h >> dEQe;
+						state <= 10;
+				end
+				10: begin
+						x <= g << dLTe;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
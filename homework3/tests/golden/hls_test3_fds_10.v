@@ -0,0 +1,94 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [7:0] a,
+	input signed [7:0] b,
+	input signed [7:0] c,
+	input signed [7:0] d,
+	input signed [7:0] e,
+	input signed [7:0] f,
+	input signed [7:0] g,
+	input signed [7:0] h,
+	input signed [7:0] num,
+	output reg signed [7:0] avg
+);
+	reg signed [31:0] t1;
+	reg signed [31:0] t2;
+	reg signed [31:0] t3;
+	reg signed [31:0] t4;
+	reg signed [31:0] t5;
+	reg signed [31:0] t6;
+	reg signed [31:0] t7;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1001;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			avg <= 0;
+			t1 <= 0;
+			t2 <= 0;
+			t3 <= 0;
+			t4 <= 0;
+			t5 <= 0;
+			t6 <= 0;
+			t7 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						t1 <= a + b;
+						state <= 2;
+				end
+				2: begin
+						t2 <= t1 + c;
+						state <= 3;
+				end
+				3: begin
+						t3 <= t2 + d;
+						state <= 4;
+				end
+				4: begin
+						t4 <= t3 + e;
+						state <= 5;
+				end
+				5: begin
+						t5 <= t4 + f;
+						state <= 6;
+				end
+				6: begin
+						t6 <= t5 + g;
+						state <= 7;
+				end
+				7: begin
+						t7 <= t6 + h;
+						state <= 8;
+				end
+				8: begin
+						avg <= t7 / num;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,87 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input [63:0] a,
+	input [63:0] b,
+	input [63:0] c,
+	input [63:0] d,
+	input [63:0] zero,
+	output reg [63:0] z
+);
+	reg [63:0] e;
+	reg [63:0] f;
+	reg [63:0] g;
+	reg gEQz;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			e <= 0;
+			f <= 0;
+			g <= 0;
+			gEQz <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						g <= a % b;
+						state <= 2;
+				end
+				2: begin
+						state <= 3;
+				end
+				3: begin
+						state <= 4;
+				end
+				4: begin
+						e <= a / b;
+						gEQz <= g == zero;
+						state <= 5;
+				end
+				5: begin
+						state <= 6;
+				end
+				6: begin
+						state <= 7;
+				end
+				7: begin
+						f <= c / d;
+						state <= 8;
+				end
+				8: begin
+						state <= 9;
+				end
+				9: begin
+						state <= 10;
+				end
+				10: begin
+						z <= gEQz ? e : f;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
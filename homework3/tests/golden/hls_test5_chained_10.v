@@ -0,0 +1,115 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input [31:0] a,
+	input [31:0] b,
+	input [31:0] c,
+	input [31:0] d,
+	input [31:0] e,
+	input [31:0] f,
+	input [31:0] g,
+	input [31:0] h,
+	input [31:0] sa,
+	output reg [31:0] avg
+);
+	reg [31:0] t1;
+	reg [31:0] t2;
+	reg [31:0] t3;
+	reg [31:0] t4;
+	reg [31:0] t5;
+	reg [31:0] t6;
+	reg [31:0] t7;
+	reg [31:0] t7div2;
+	reg [31:0] t7div4;
+	wire [31:0] t1_chain0;
+	wire [31:0] t3_chain2;
+	wire [31:0] t5_chain4;
+	wire [31:0] t7_chain6;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	assign t1_chain0 = a + b;
+	assign t3_chain2 = t2 + d;
+	assign t5_chain4 = t4 + f;
+	assign t7_chain6 = t6 + h;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			avg <= 0;
+			t1 <= 0;
+			t2 <= 0;
+			t3 <= 0;
+			t4 <= 0;
+			t5 <= 0;
+			t6 <= 0;
+			t7 <= 0;
+			t7div2 <= 0;
+			t7div4 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						t1 <= t1_chain0;
+						t2 <= t1_chain0 + c;
+						state <= 2;
+				end
+				2: begin
+						t3 <= t3_chain2;
+						t4 <= t3_chain2 + e;
+						state <= 3;
+				end
+				3: begin
+						t5 <= t5_chain4;
+						t6 <= t5_chain4 + g;
+						state <= 4;
+				end
+				4: begin
+						t7 <= t7_chain6;
+						t7div2 <= t7_chain6 >> sa;
+						state <= 5;
+				end
+				5: begin
+						t7div4 <= t7div2 >> sa;
+						state <= 6;
+				end
+				6: begin
+						state <= 7;
+				end
+				7: begin
+						state <= 8;
+				end
+				8: begin
+						state <= 9;
+				end
+				9: begin
+						state <= 10;
+				end
+				10: begin
+						avg <= t7div4 >> sa;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
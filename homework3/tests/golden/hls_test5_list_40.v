@@ -0,0 +1,106 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input [31:0] a,
+	input [31:0] b,
+	input [31:0] c,
+	input [31:0] d,
+	input [31:0] e,
+	input [31:0] f,
+	input [31:0] g,
+	input [31:0] h,
+	input [31:0] sa,
+	output reg [31:0] avg
+);
+	reg [31:0] t1;
+	reg [31:0] t2;
+	reg [31:0] t3;
+	reg [31:0] t4;
+	reg [31:0] t5;
+	reg [31:0] t6;
+	reg [31:0] t7;
+	reg [31:0] t7div2;
+	reg [31:0] t7div4;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			avg <= 0;
+			t1 <= 0;
+			t2 <= 0;
+			t3 <= 0;
+			t4 <= 0;
+			t5 <= 0;
+			t6 <= 0;
+			t7 <= 0;
+			t7div2 <= 0;
+			t7div4 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						t1 <= a + b;
+						state <= 2;
+				end
+				2: begin
+						t2 <= t1 + c;
+						state <= 3;
+				end
+				3: begin
+						t3 <= t2 + d;
+						state <= 4;
+				end
+				4: begin
+						t4 <= t3 + e;
+						state <= 5;
+				end
+				5: begin
+						t5 <= t4 + f;
+						state <= 6;
+				end
+				6: begin
+						t6 <= t5 + g;
+						state <= 7;
+				end
+				7: begin
+						t7 <= t6 + h;
+						state <= 8;
+				end
+				8: begin
+						t7div2 <= t7 >> sa;
+						state <= 9;
+				end
+				9: begin
+						t7div4 <= t7div2 >> sa;
+						state <= 10;
+				end
+				10: begin
+						avg <= t7div4 >> sa;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
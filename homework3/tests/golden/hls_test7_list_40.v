@@ -0,0 +1,110 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] u,
+	input signed [31:0] x,
+	input signed [31:0] y,
+	input signed [31:0] dx,
+	input signed [31:0] a,
+	input signed [31:0] three,
+	output reg signed [31:0] u1,
+	output reg signed [31:0] x1,
+	output reg signed [31:0] y1,
+	output reg signed [31:0] c
+);
+	reg signed [31:0] t1;
+	reg signed [31:0] t2;
+	reg signed [31:0] t3;
+	reg signed [31:0] t4;
+	reg signed [31:0] t5;
+	reg signed [31:0] t6;
+	reg signed [31:0] t7;
+	reg signed [31:0] vx1;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1100;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			u1 <= 0;
+			x1 <= 0;
+			y1 <= 0;
+			c <= 0;
+			t1 <= 0;
+			t2 <= 0;
+			t3 <= 0;
+			t4 <= 0;
+			t5 <= 0;
+			t6 <= 0;
+			t7 <= 0;
+			vx1 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						x1 <= x + dx;
+						t1 <= three * x;
+						state <= 2;
+				end
+				2: begin
+						c <= x1 < a;
+						state <= 3;
+				end
+				3: begin
+						t2 <= u * dx;
+						state <= 4;
+				end
+				4: begin
+						state <= 5;
+				end
+				5: begin
+						t5 <= three * y;
+						y1 <= y + t2;
+						state <= 6;
+				end
+				6: begin
+						state <= 7;
+				end
+				7: begin
+						t3 <= t1 * t2;
+						state <= 8;
+				end
+				8: begin
+						state <= 9;
+				end
+				9: begin
+						t4 <= u - t3;
+						t6 <= t5 * dx;
+						state <= 10;
+				end
+				10: begin
+						state <= 11;
+				end
+				11: begin
+						u1 <= t4 - t6;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
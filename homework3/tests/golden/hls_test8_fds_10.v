@@ -0,0 +1,110 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] x0,
+	input signed [31:0] x1,
+	input signed [31:0] x2,
+	input signed [31:0] x3,
+	input signed [31:0] y0,
+	input signed [31:0] c0,
+	input signed [31:0] five,
+	input signed [31:0] ten,
+	output reg signed [31:0] d1,
+	output reg signed [31:0] d2,
+	output reg signed [31:0] e,
+	output reg signed [31:0] f,
+	output reg signed [31:0] g,
+	output reg signed [31:0] h
+);
+	reg signed [31:0] t1;
+	reg signed [31:0] t2;
+	reg signed [31:0] t3;
+	reg signed [31:0] vd1;
+	reg signed [31:0] ve;
+	reg signed [31:0] vf;
+	reg signed [31:0] vg;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			d1 <= 0;
+			d2 <= 0;
+			e <= 0;
+			f <= 0;
+			g <= 0;
+			h <= 0;
+			t1 <= 0;
+			t2 <= 0;
+			t3 <= 0;
+			vd1 <= 0;
+			ve <= 0;
+			vf <= 0;
+			vg <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						t2 <= x1 + x2;
+						state <= 2;
+				end
+				2: begin
+						t3 <= x3 + c0;
+						state <= 3;
+				end
+				3: begin
+						e <= t2 * t3;
+						g <= x0 - ten;
+						state <= 4;
+				end
+				4: begin
+						state <= 5;
+				end
+				5: begin
+						f <= e * y0;
+						state <= 6;
+				end
+				6: begin
+						t1 <= x0 + x1;
+						state <= 7;
+				end
+				7: begin
+						d1 <= t1 * c0;
+						h <= f + g;
+						state <= 8;
+				end
+				8: begin
+						state <= 9;
+				end
+				9: begin
+						d2 <= d1 * five;
+						state <= 10;
+				end
+				10: begin
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,63 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] a,
+	input signed [31:0] b,
+	input signed [31:0] c,
+	input signed [31:0] d,
+	output reg signed [31:0] z
+);
+	reg signed [31:0] x;
+	reg signed [31:0] y;
+
+	reg [2:0] state;
+
+	localparam Wait = 3'b000;
+	localparam Final = 3'b101;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			x <= 0;
+			y <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						x <= a + b;
+						state <= 2;
+				end
+				2: begin
+						y <= x + c;
+						state <= 3;
+				end
+				3: begin
+						x <= y + d;
+						state <= 4;
+				end
+				4: begin
+						z <= x + a;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,127 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] a,
+	input signed [31:0] b,
+	input signed [31:0] c,
+	input signed [31:0] d,
+	input signed [31:0] e,
+	input signed [31:0] f,
+	input signed [31:0] g,
+	input signed [31:0] h,
+	input signed [31:0] sa,
+	input signed [31:0] one,
+	input signed [31:0] two,
+	input signed [31:0] four,
+	output reg signed [31:0] avg
+);
+	reg signed [31:0] t1;
+	reg signed [31:0] t2;
+	reg signed [31:0] t3;
+	reg signed [31:0] t4;
+	reg signed [31:0] t5;
+	reg signed [31:0] t6;
+	reg signed [31:0] t7;
+	reg signed [31:0] t7div2;
+	reg signed [31:0] t7div4;
+	reg csa1;
+	reg csa2;
+	reg csa3;
+
+	reg [3:0] state;
+
+	localparam Wait = 4'b0000;
+	localparam Final = 4'b1011;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			avg <= 0;
+			t1 <= 0;
+			t2 <= 0;
+			t3 <= 0;
+			t4 <= 0;
+			t5 <= 0;
+			t6 <= 0;
+			t7 <= 0;
+			t7div2 <= 0;
+			t7div4 <= 0;
+			csa1 <= 0;
+			csa2 <= 0;
+			csa3 <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						t1 <= a + b;
+						csa1 <= sa > one;
+						state <= 2;
+				end
+				2: begin
+						t2 <= t1 + c;
+						csa2 <= sa > two;
+						state <= 3;
+				end
+				3: begin
+						t3 <= t2 + d;
+						csa3 <= sa > four;
+						state <= 4;
+				end
+				4: begin
+						t4 <= t3 + e;
+						state <= 5;
+				end
+				5: begin
+						t5 <= t4 + f;
+						state <= 6;
+				end
+				6: begin
+						t6 <= t5 + g;
+						state <= 7;
+				end
+				7: begin
+						t7 <= t6 + h;
+						state <= 8;
+				end
+				8: begin
+						if (csa1) begin
+							t7div2 <= t7 >> one;
+						end
+						if (!csa2 && csa1) begin
+							t7div4 <= t7 >> one;
+						end
+						state <= 9;
+				end
+				9: begin
+						if (csa3 && !csa2 && csa1) begin
+							avg <= t7div4 >> one;
+						end
+						state <= 10;
+				end
+				10: begin
+						if (csa2 && csa1) begin
+							t7div4 <= t7div2 >> one;
+						end
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,87 @@
+// Generated by University of Arizona - ECE 574 - HLS Tool
+// Authors: Mustafa Ghanim and Umut Suluhan
+
+`timescale 1ns / 1ps
+module HLSM(
+	input Clk, Rst, Start,
+	output reg Done,
+	input signed [31:0] a,
+	input signed [31:0] b,
+	input signed [31:0] c,
+	input signed [31:0] zero,
+	input signed [31:0] one,
+	input t,
+	output reg signed [31:0] z,
+	output reg signed [31:0] x
+);
+	reg signed [31:0] e;
+	reg signed [31:0] g;
+	reg signed [31:0] d;
+	reg signed [31:0] f;
+
+	reg [2:0] state;
+
+	localparam Wait = 3'b000;
+	localparam Final = 3'b101;
+
+	always @(posedge Clk) begin
+		if (Rst) begin
+			state <= Wait;
+			z <= 0;
+			x <= 0;
+			e <= 0;
+			g <= 0;
+			d <= 0;
+			f <= 0;
+		end
+		else begin
+			case (state)
+				Wait: begin
+					if (Start == 1) begin
+						state <= 1;
+					end
+					else begin
+						state <= Wait;
+					end
+				end
+				1: begin
+						d <= a + b;
+						state <= 2;
+				end
+				2: begin
+						if (t) begin
+							d <= a - one;
+						end
+						if (t) begin
+							f <= a + c;
+						end
+						if (!t) begin
+							e <= a + c;
+						end
+						if (!t) begin
+							f <= a * c;
+						end
+						state <= 3;
+				end
+				3: begin
+						if (!t) begin
+							g <= d > e;
+						end
+						state <= 4;
+				end
+				4: begin
+						if (!t) begin
+							z <= g ? d : e;
+						end
+						x <= f - d;
+						state <= Final;
+				end
+				Final: begin
+					Done <= 1;
+					state <= Wait;
+				end
+			endcase
+		end
+	end
+
+endmodule
@@ -0,0 +1,4 @@
+input Int8 a, b
+output Int8 z
+
+z = a ** b
@@ -0,0 +1,30 @@
+# Runs hlsyn once for ctest:
+#   cmake -DHLSYN=<binary> -DARGS=<arguments separated by '|'> [-DEXIT_CODE=N] [-DEXPECT=<regex>]
+#         [-DOUTPUT=<Verilog written by the run> -DGOLDEN=<expected Verilog>] -P run_hlsyn.cmake
+# The exit code defaults to 0 and EXPECT is matched against stdout and stderr together.
+# Verilog is compared without its generation date.
+string(REPLACE "|" ";" ARGS "${ARGS}")
+if(NOT DEFINED EXIT_CODE)
+    set(EXIT_CODE 0)
+endif()
+
+execute_process(COMMAND ${HLSYN} ${ARGS} RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+if(NOT result STREQUAL EXIT_CODE)
+    message(FATAL_ERROR "hlsyn exited with ${result} instead of ${EXIT_CODE}:\n${output}")
+endif()
+if(DEFINED EXPECT AND NOT output MATCHES "${EXPECT}")
+    message(FATAL_ERROR "hlsyn output does not match '${EXPECT}':\n${output}")
+endif()
+
+if(DEFINED GOLDEN)
+    if(NOT EXISTS "${OUTPUT}")
+        message(FATAL_ERROR "hlsyn did not write ${OUTPUT}:\n${output}")
+    endif()
+    file(READ "${OUTPUT}" actual)
+    file(READ "${GOLDEN}" expected)
+    string(REGEX REPLACE "// Date and Time:[^\n]*\n" "" actual "${actual}")
+    string(REGEX REPLACE "// Date and Time:[^\n]*\n" "" expected "${expected}")
+    if(NOT actual STREQUAL expected)
+        message(FATAL_ERROR "${OUTPUT} differs from ${GOLDEN}")
+    endif()
+endif()